@@ -1,3 +1,4 @@
+#include "../dataStructures/csrGraph.h"
 #include "../dataStructures/maxCardinalitySet.h"
 #include "../dataStructures/reducedSet.h"
 #include "alphaAcyclic.h"
@@ -169,21 +170,25 @@ vector<int> AlphaAcyclic::getJoinTree(const Hypergraph& hg)
     // gamma in paper.
     vector<int> parIdx(m, -1);
 
-    // Counts how many vertices in each hyperedge are already marked.
-    // Allows to skip hyperedges with all vertices marked.
-    // Does not affect correctness, only there for speed-up.
-    vector<size_t> eSize(m, 0);
+    // The size of a set is the number of marked vertices in its hyperedge.
+    // Each hyperedge only counts its own vertices; hence, no set grows beyond
+    // the largest hyperedge.
+    size_t maxSize = 0;
+    for (int eId = 0; eId < m; eId++)
+    {
+        maxSize = max(maxSize, hg[eId].size());
+    }
 
-    for (MaxCardinalitySet sets(m); !sets.isEmpty(); )
+    for (PackedMaxCardinalitySet sets(m, maxSize); !sets.isEmpty(); )
     {
         int S = sets.removeMax();
 
         // Skip hyperedges with all vertices marked.
-        if (eSize[S] == hg[S].size()) continue;
+        // Does not affect correctness, only there for speed-up.
+        if (sets.sizeOf(S) == hg[S].size()) continue;
 
         eCtr++;
         eOrder[eCtr] = S;
-        eSize[S] = hg[S].size();
 
         for (const int& vId : hg[S])
         {
@@ -197,9 +202,7 @@ vector<int> AlphaAcyclic::getJoinTree(const Hypergraph& hg)
                 if (eId == S) continue;
 
                 parIdx[eId] = eCtr;
-
                 sets.increaseSize(eId);
-                eSize[eId]++;
             }
         }
     }
@@ -212,14 +215,28 @@ vector<int> AlphaAcyclic::getJoinTree(const Hypergraph& hg)
     // all vertices in S which were discovered before processing S are also in the parent of S.
 
 
-    // Stores the hyperedges based on their parent-index.
-    // That is, childIds[i] stores all hyperedges S with parIdx[S] == i.
-    vector<vector<int>> childIds(m);
+    // Stores the hyperedges based on their parent-index in a single array.
+    // That is, childIds[childStart[i]] to childIds[childStart[i + 1] - 1] are
+    // all hyperedges S with parIdx[S] == i.
+    vector<int> childStart(m + 1, 0);
+    vector<int> childIds(m);
 
     for (int eId = 0; eId < m; eId++)
     {
         if (parIdx[eId] < 0) continue;
-        childIds[parIdx[eId]].push_back(eId);
+        childStart[parIdx[eId]]++;
+    }
+
+    for (size_t i = 1; i <= m; i++)
+    {
+        childStart[i] += childStart[i - 1];
+    }
+
+    // Fill from the back; afterwards, childStart[i] is the start of i's range.
+    for (int eId = m - 1; eId >= 0; eId--)
+    {
+        if (parIdx[eId] < 0) continue;
+        childIds[--childStart[parIdx[eId]]] = eId;
     }
 
     // States for each vertex the last "parent" it was in.
@@ -238,8 +255,9 @@ vector<int> AlphaAcyclic::getJoinTree(const Hypergraph& hg)
         }
 
         // ... and check all their children.
-        for (const int& S : childIds[eIdx])
+        for (int cIdx = childStart[eIdx]; cIdx < childStart[eIdx + 1]; cIdx++)
         {
+            int S = childIds[cIdx];
             // Check if all vertices in S which were discovered before processing S are also in the parent of S.
             for (const int& vId : hg[S])
             {
@@ -308,8 +326,8 @@ Hypergraph AlphaAcyclic::separatorHG(const Hypergraph& hg, const vector<int>& jo
         int pId = joinTree[eId];
         if (pId < 0) continue; // Skip root.
 
-        const vector<int>& eList = hg[eId];
-        const vector<int>& pList = hg[pId];
+        IdSpan eList = hg[eId];
+        IdSpan pList = hg[pId];
 
         for (size_t e = 0, p = 0; e < eList.size() && p < pList.size(); )
         {
@@ -408,236 +426,357 @@ AlphaAcyclic::orderPair AlphaAcyclic::joinTreeDfs(const vector<int>& joinTree, i
     return orders;
 }
 
-// Computes the union join graph for a given acyclic hypergraph.
-Graph AlphaAcyclic::unionJoinGraph(const Hypergraph& hg, SubsetGraph::ssgAlgo algo)
+// Concatenates the given lists into a single list and clears them.
+vector<intPair> concatenate(vector<vector<intPair>>& lists)
 {
-    // Implements Algorithm 2 from my paper.
+    vector<size_t> starts(lists.size() + 1, 0);
+    for (size_t i = 0; i < lists.size(); i++)
+    {
+        starts[i + 1] = starts[i] + lists[i].size();
+    }
 
-    // --- Outline ---
+    vector<intPair> result(starts[lists.size()]);
 
-    // 1  Find a join tree for H and call Algorithm 1.
-    //    Let T be the resulting join tree and S_H the resulting family of
-    //    separators (i.e., the hyperedges of S(H)).
+    parallelFor(lists.size(), 1, [&](size_t tId, size_t fr, size_t to)
+    {
+        for (size_t i = fr; i < to; i++)
+        {
+            copy(lists[i].begin(), lists[i].end(), result.begin() + starts[i]);
+            vector<intPair>().swap(lists[i]);
+        }
+    });
 
-    // 2  Use algorithm A to compute the subset graph G_S of S_H.
+    return result;
+}
 
-    // 3  Create a new graph G = (E, E_G) with E_G = ∅.
+// Partitions the hyperedges represented by the supersets of a separator S
+// (lines 6 and 7 of Algorithm 2).
+// spList contains all separators S' with S ⊆ S' (including S itself).
+void separatorSides(int sId, const vector<int>& spList, const vector<int>& joinTree,
+                    const vector<size_t>& pre, const vector<size_t>& post,
+                    vector<int>& downList, vector<int>& aboveList)
+{
+    for (const int& spId : spList)
+    {
+        // Hyperedge below S'.
+        // The way the sparator hypergraph is created, each separator has
+        // the same ID as the hyperedge below it in the rooted join tree.
+        int chiId = spId;
 
-    // 4  For Each S ∈ S_H
+        // Hyperedge above S'.
+        int parId = joinTree[chiId];
 
-    // 5      Use G_S to determine all separators S' with S ⊆ S' (including S).
 
-    // 6      For each such S', let EE' be the edge of T which S' represents
-    //        and let E be the hyperedge farther away from S in T.
-    //        Add E to a set bbE of hyperedges.
-    //        If S and S' represent the same edge of T, also add E'.
+        // ----------------------------------
+        // From proof in paper:
 
-    // 7      Partition bbE into two sets bbE_1 and bbE_2 based on which side
-    //        of S they are in T.
+        // x is a descendant of y if and only if
+        // pre(x) > pre(y) and post(x) < post(y).
 
-    // 8      For each pair E_1, E_2 with E_1 ∈ bbE_1 and E_2 ∈ bbE_2,
-    //        add E_1E_2 into E_G.
+        // There are four cases when determining which of E and E' to pick:
+        // 1) If S and S' represent the same edge, add E and E'.
+        // 2) If S' is a descendant of S, add the child-hyperedge.
+        // 3) If S' is an ancestor of S, add the parent-hyperedge.
+        // 4) If S' is neither an ancestor nor a descendant of S,
+        //    add the child-hyperedge.
 
+        // Clearly, one side of S contains all its descendants and the other
+        // side all remaining hyperedges and separators.
 
+        // ----------------------------------
 
-    // --- Line 1: Compute join tree and separator hypergraph. ---
 
-    vector<int> joinTree = getJoinTree(hg);
+        // -- Determine ancestor/descendant relationship. --
 
-    // Implementation of join tree algorithm has the result that the hyperedge
-    // with the largest ID is automatically the root.
-    int rootId = hg.getESize() - 1;
+        // We use the ID of the hyperedge below S and S' (which give S and
+        // S' their IDs). If we would compute a pre- or post-order of T
+        // where we treat separators as their own nodes, they would be
+        // directly before (in pre-) or after (in post-) their corresponding
+        // hyperedge. Thus, we still determine ancestory correctly.
 
-    Hypergraph sepHg = separatorHG(hg, joinTree);
+        bool sIsDec = pre[sId] > pre[spId] && post[sId] < post[spId];
+        bool sIsAnc = pre[spId] > pre[sId] && post[spId] < post[sId];
 
 
-    // --- Preprocessing for lines 6 and 7. ---
+        // -- Add hyperedges. --
 
-    // To determine which hyperedges are farther away and on which side of a
-    // separator they are, we compute pre- and post-order of the join tree.
+        // Case 1.
+        if (spId == sId)
+        {
+            downList.push_back(chiId);
+            aboveList.push_back(parId);
+        }
 
-    orderPair jtDfs = joinTreeDfs(joinTree, rootId);
+        // Case 2.
+        else if (sIsAnc)
+        {
+            // S' is a descendent of S.
+            // Hence, the hyperedge below S' is farther from and below S.
+            downList.push_back(chiId);
+        }
 
-    vector<size_t>& pre = jtDfs.first;
-    vector<size_t>& post = jtDfs.second;
+        // Case 3.
+        // Never happens. Assume we have case 3. All vertices in S would be
+        // in the hyperedge above S'. Thus, the join tree algorithm sets
+        // the hyperedge above S' as parent of the hyperedge below S.
+        else if (sIsDec)
+        {
+            // S' is an ancestor of S.
+            // Hence, the hyperedge above S' is farther from and above S.
+            aboveList.push_back(parId);
+        }
 
+        // Case 4.
+        else
+        {
+            // S' is neither an ancestor nor a descendant of S.
+            // Hence, the hyperedge below S' is farther from and above S.
+            aboveList.push_back(chiId);
+        }
+    }
+}
 
-    // --- Line 2: Compute subset graph. ---
+// Computes the edges of the union join graph (lines 4 to 8 of Algorithm 2).
+// Emits all pairs of all separators and removes duplicates afterwards.
+vector<intPair> unionJoinEdgesAll(const vector<vector<int>>& superSets, const vector<int>& joinTree,
+                                  const vector<size_t>& pre, const vector<size_t>& post)
+{
+    // Separators are independent of each other. Hence, we process them with
+    // multiple threads. Each thread collects its edges in its own buffer.
+    // Different separators can produce the same edge; we remove these
+    // duplicates at the end.
 
-    // List of edges.
-    vector<intPair> ssgEdges = algo(sepHg);
+    vector<vector<intPair>> buffers(threadCount());
 
 
-    // -- Preprocessing for line 5. ---
+    // --- Line 4: Loop over all separators S. ---
 
-    // We later want to get the larger sets of a given set.
-    // We therefore build a structure that allows to do that easily.
+    // The work per separator varies a lot. Small blocks keep threads busy.
+    parallelFor(superSets.size(), 64, [&](size_t thread, size_t fr, size_t to)
+    {
+        vector<intPair>& eList = buffers[thread];
 
-    vector<vector<int>> superSets;
-    superSets.resize(sepHg.getESize());
+        // All hyperedges that are below S, i.e., descendants of S in T.
+        vector<int> downList; // bbE_1 in paper.
 
-    // Add separators themself.
-    for (int sId = 0; sId < superSets.size(); sId++)
-    {
-        superSets[sId].push_back(sId);
-    }
+        // All hyperedges that are above S, i.e., not descendants of S in T.
+        vector<int> aboveList; // bbE_2 in paper.
 
-    // Add all subset relations.
-    for (const intPair& edge : ssgEdges)
-    {
-        // An edge points from the large (.first) to the small (.second) set.
-        const int& lrgId = edge.first;
-        const int& smlId = edge.second;
+        for (int sId = fr; sId < to; sId++)
+        {
+            // --- Line 5: Determine all S' with S ⊆ S' (including S). ---
 
-        superSets[smlId].push_back(lrgId);
-    }
+            const vector<int>& spList = superSets[sId];
 
 
-    // --- Line 3: Create empty union join graph. ---
+            // --- Lines 6 and 7: Determine and partition hyperedges. ---
 
-    vector<intPair> eList;
-    vector<int> wList; // Will all be 0.
+            downList.clear();
+            aboveList.clear();
+            separatorSides(sId, spList, joinTree, pre, post, downList, aboveList);
 
 
-    // --- Line 4: Loop over all separators S. ---
+            // --- Line 8: Add all E_1E_2 pairs. ---
 
-    for (int sId = 0; sId < sepHg.getESize(); sId++)
-    {
-        // --- Line 5: Determine all S' with S ⊆ S' (including S). ---
+            for (const int& e1 : downList)
+            {
+                for (const int& e2 : aboveList)
+                {
+                    // Ensure that from > to.
+                    int fId = max(e1, e2);
+                    int tId = min(e1, e2);
 
-        const vector<int>& spList = superSets[sId];
+                    eList.push_back(intPair(fId, tId));
+                }
+            }
+        }
+    });
 
+    vector<intPair> eList = concatenate(buffers);
+    Sorting::sortUnique(eList);
 
-        // --- Line 6: For each, S' determine hyperedges it represents. ---
-        //     Line 7: Partition then based on their side of S in T.
+    return eList;
+}
 
+// Computes the union join graph from the supersets of all separators (lines 4 to 8 of Algorithm 2).
+CsrGraph AlphaAcyclic::unionJoinCsr(size_t m, const vector<vector<int>>& superSets, const vector<int>& joinTree,
+                                    const orderPair& jtDfs, bool half)
+{
+    // Hyperedges which share many separators would be paired many times.
+    // Instead of handling one separator at a time, we handle one hyperedge E
+    // at a time: for each separator S with E on one side of S, we visit all
+    // hyperedges E' on the other side. A marker array remembers which E' we
+    // already paired with E. That way, we only store each edge once and
+    // memory scales with the size of the union join graph.
 
-        // All hyperedges that are below S, i.e., descendants of S in T.
-        vector<int> downList; // bbE_1 in paper.
+    const size_t sepCount = superSets.size();
 
-        // All hyperedges that are above S, i.e., not descendants of S in T.
-        vector<int> aboveList; // bbE_2 in paper.
+    const vector<size_t>& pre = jtDfs.first;
+    const vector<size_t>& post = jtDfs.second;
+
+
+    // --- Lines 4 to 7: Determine sides of all separators. ---
 
+    vector<vector<int>> downLists(sepCount);
+    vector<vector<int>> aboveLists(sepCount);
 
-        for (const int& spId : spList)
+    parallelFor(sepCount, 64, [&](size_t thread, size_t fr, size_t to)
+    {
+        for (int sId = fr; sId < to; sId++)
         {
-            // Hyperedge below S'.
-            // The way the sparator hypergraph is created, each separator has
-            // the same ID as the hyperedge below it in the rooted join tree.
-            int chiId = spId;
+            separatorSides(sId, superSets[sId], joinTree, pre, post, downLists[sId], aboveLists[sId]);
+        }
+    });
 
-            // Hyperedge above S'.
-            int parId = joinTree[chiId];
+    // For each hyperedge E, all separators with E below or above them.
+    vector<vector<int>> belowOf(m);
+    vector<vector<int>> aboveOf(m);
 
+    for (int sId = 0; sId < sepCount; sId++)
+    {
+        for (const int& eId : downLists[sId]) belowOf[eId].push_back(sId);
+        for (const int& eId : aboveLists[sId]) aboveOf[eId].push_back(sId);
+    }
 
-            // ----------------------------------
-            // From proof in paper:
 
-            // x is a descendant of y if and only if
-            // pre(x) > pre(y) and post(x) < post(y).
+    // --- Line 8: Add all E_1E_2 pairs. ---
 
-            // There are four cases when determining which of E and E' to pick:
-            // 1) If S and S' represent the same edge, add E and E'.
-            // 2) If S' is a descendant of S, add the child-hyperedge.
-            // 3) If S' is an ancestor of S, add the parent-hyperedge.
-            // 4) If S' is neither an ancestor nor a descendant of S,
-            //    add the child-hyperedge.
+    // marker[E'] == E if E' was already paired with E.
+    vector<vector<int>> markers(threadCount());
 
-            // Clearly, one side of S contains all its descendants and the other
-            // side all remaining hyperedges and separators.
+    // Each hyperedge E only lists the hyperedges E' < E. The graph adds the
+    // other direction if needed.
+    auto lowerRow = [&](size_t tId, int eId, vector<int>& nei, vector<int>& wei)
+    {
+        vector<int>& marker = markers[tId];
+        if (marker.empty()) marker.resize(m, -1);
 
-            // ----------------------------------
+        auto addPairs = [&](const vector<int>& others)
+        {
+            for (const int& oId : others)
+            {
+                if (oId > eId || marker[oId] == eId) continue;
 
+                marker[oId] = eId;
+                nei.push_back(oId);
+            }
+        };
 
-            // -- Determine ancestor/descendant relationship. --
+        for (const int& sId : belowOf[eId]) addPairs(aboveLists[sId]);
+        for (const int& sId : aboveOf[eId]) addPairs(downLists[sId]);
+    };
 
-            // We use the ID of the hyperedge below S and S' (which give S and
-            // S' their IDs). If we would compute a pre- or post-order of T
-            // where we treat separators as their own nodes, they would be
-            // directly before (in pre-) or after (in post-) their corresponding
-            // hyperedge. Thus, we still determine ancestory correctly.
+    return CsrGraph::fromRows(m, lowerRow, false, half);
+}
 
-            bool sIsDec = pre[sId] > pre[spId] && post[sId] < post[spId];
-            bool sIsAnc = pre[spId] > pre[sId] && post[spId] < post[sId];
+// Computes the edges of the union join graph (lines 4 to 8 of Algorithm 2).
+// Suppresses duplicates while generating edges.
+vector<intPair> unionJoinEdgesMarked(const vector<vector<int>>& superSets, const vector<int>& joinTree,
+                                     const vector<size_t>& pre, const vector<size_t>& post)
+{
+    // The rows of a half-stored graph are sorted by from-ID and then to-ID.
+    // Hence, we can read the edges directly in the order Graph needs.
 
+    const size_t m = superSets.size() + 1;
+    CsrGraph ujg = AlphaAcyclic::unionJoinCsr(m, superSets, joinTree, AlphaAcyclic::orderPair(pre, post), true);
+    return ujg.toEdgeList();
+}
 
-            // -- Add hyperedges. --
+// Computes the edges of the union join graph (lines 4 to 8 of Algorithm 2).
+// superSets[sId] lists all separators S' with S ⊆ S' (including S itself).
+// If lowMemory is set, duplicates are suppressed while generating edges.
+vector<intPair> unionJoinEdges(const vector<vector<int>>& superSets, const vector<int>& joinTree,
+                               const vector<size_t>& pre, const vector<size_t>& post, bool lowMemory)
+{
+    if (lowMemory) return unionJoinEdgesMarked(superSets, joinTree, pre, post);
+    return unionJoinEdgesAll(superSets, joinTree, pre, post);
+}
 
-            // Case 1.
-            if (spId == sId)
-            {
-                downList.push_back(chiId);
-                aboveList.push_back(parId);
-            }
+// Computes the union join graph for a given acyclic hypergraph.
+Graph AlphaAcyclic::unionJoinGraph(const Hypergraph& hg, SubsetGraph::ssgStream algo, bool lowMemory)
+{
+    // Implements Algorithm 2 from my paper.
 
-            // Case 2.
-            else if (sIsAnc)
-            {
-                // S' is a descendent of S.
-                // Hence, the hyperedge below S' is farther from and below S.
-                downList.push_back(chiId);
-            }
+    // --- Outline ---
 
-            // Case 3.
-            // Never happens. Assume we have case 3. All vertices in S would be
-            // in the hyperedge above S'. Thus, the join tree algorithm sets
-            // the hyperedge above S' as parent of the hyperedge below S.
-            else if (sIsDec)
-            {
-                // S' is an ancestor of S.
-                // Hence, the hyperedge above S' is farther from and above S.
-                aboveList.push_back(parId);
-            }
+    // 1  Find a join tree for H and call Algorithm 1.
+    //    Let T be the resulting join tree and S_H the resulting family of
+    //    separators (i.e., the hyperedges of S(H)).
 
-            // Case 4.
-            else
-            {
-                // S' is neither an ancestor nor a descendant of S.
-                // Hence, the hyperedge below S' is farther from and above S.
-                aboveList.push_back(chiId);
-            }
-        }
+    // 2  Use algorithm A to compute the subset graph G_S of S_H.
 
+    // 3  Create a new graph G = (E, E_G) with E_G = ∅.
 
-        // --- Line 8: Add all E_1E_2 pairs. ---
+    // 4  For Each S ∈ S_H
 
-        for (const int& e1 : downList)
-        {
-            for (const int& e2 : aboveList)
-            {
-                // Ensure that from > to.
-                int fId = max(e1, e2);
-                int tId = min(e1, e2);
+    // 5      Use G_S to determine all separators S' with S ⊆ S' (including S).
 
-                eList.push_back(sizePair(fId, tId));
-            }
-        }
-    }
+    // 6      For each such S', let EE' be the edge of T which S' represents
+    //        and let E be the hyperedge farther away from S in T.
+    //        Add E to a set bbE of hyperedges.
+    //        If S and S' represent the same edge of T, also add E'.
 
-    Sorting::radixSort(eList);
+    // 7      Partition bbE into two sets bbE_1 and bbE_2 based on which side
+    //        of S they are in T.
 
-    // Remove duplicates.
-    if (eList.size() > 1)
-    {
-        size_t preIdx = 0;
+    // 8      For each pair E_1, E_2 with E_1 ∈ bbE_1 and E_2 ∈ bbE_2,
+    //        add E_1E_2 into E_G.
 
-        for (size_t i = 1; i < eList.size(); i++)
-        {
-            intPair prev = eList[preIdx];
-            intPair curr = eList[i];
 
-            if (prev == curr) continue;
 
-            preIdx++;
-            eList[preIdx] = curr;
-        }
+    // --- Line 1: Compute join tree and separator hypergraph. ---
+
+    vector<int> joinTree = getJoinTree(hg);
+
+    // Implementation of join tree algorithm has the result that the hyperedge
+    // with the largest ID is automatically the root.
+    int rootId = hg.getESize() - 1;
 
-        eList.resize(preIdx + 1);
+    Hypergraph sepHg = separatorHG(hg, joinTree);
+
+
+    // --- Preprocessing for lines 6 and 7. ---
+
+    // To determine which hyperedges are farther away and on which side of a
+    // separator they are, we compute pre- and post-order of the join tree.
+
+    orderPair jtDfs = joinTreeDfs(joinTree, rootId);
+
+    vector<size_t>& pre = jtDfs.first;
+    vector<size_t>& post = jtDfs.second;
+
+
+    // --- Line 2: Compute subset graph. ---
+    //     Preprocessing for line 5.
+
+    // We later want to get the larger sets of a given set.
+    // We therefore build a structure that allows to do that easily.
+    // Edges are added directly as the algorithm finds them. That way, we never
+    // store the list of edges.
+
+    vector<vector<int>> superSets;
+    superSets.resize(sepHg.getESize());
+
+    // Add separators themself.
+    for (int sId = 0; sId < superSets.size(); sId++)
+    {
+        superSets[sId].push_back(sId);
     }
 
-    wList.resize(eList.size(), 0);
+    // Add all subset relations.
+    // An edge points from the large (lrgId) to the small (smlId) set.
+    algo(sepHg, [&superSets](int lrgId, int smlId)
+    {
+        superSets[smlId].push_back(lrgId);
+    });
+
+
+    // --- Lines 3 to 8: Create union join graph and add all edges. ---
+
+    vector<intPair> eList = unionJoinEdges(superSets, joinTree, pre, post, lowMemory);
 
-    return Graph(eList, wList);
+    // The list is sorted and free of duplicates by construction.
+    return Graph(move(eList), false);
 }
 
 // Computes the edges of the subset graph of the separator hypergraph.
@@ -680,7 +819,7 @@ vector<intPair> separatorSSG(const Hypergraph& hg, const vector<size_t>& postIdx
     for (size_t eIdx = 0; eIdx < m; eIdx++)
     {
         int eId = postOrder[eIdx];
-        const vector<int>& vLst = hg[eId];
+        IdSpan vLst = hg[eId];
 
         for (const int& vId : vLst)
         {
@@ -706,7 +845,7 @@ vector<intPair> separatorSSG(const Hypergraph& hg, const vector<size_t>& postIdx
 
     for (int yId = 0; yId < m - 1 /* ignore root */; yId++)
     {
-        const vector<int>& vertices = hg[yId];
+        IdSpan vertices = hg[yId];
         if (vertices.size() <= 0) throw std::invalid_argument("Invalid hypergraph.");
 
         // Compute F.y using the following relation:
@@ -754,36 +893,13 @@ vector<intPair> separatorSSG(const Hypergraph& hg, const vector<size_t>& postIdx
     return result;
 }
 
-// Computes the union join graph for a given acyclic hypergraph.
-Graph AlphaAcyclic::unionJoinGraph(const Hypergraph& hg)
+// Computes for each separator all separators which are a superset (including itself).
+// Uses separatorSSG() to compute the subset graph of the separator hypergraph.
+vector<vector<int>> separatorSuperSets(const Hypergraph& hg, const vector<size_t>& postIdx)
 {
-    // --- Line 1: Compute join tree and separator hypergraph. ---
-
-    vector<int> joinTree = getJoinTree(hg);
-
-    // Implementation of join tree algorithm has the result that the hyperedge
-    // with the largest ID is automatically the root.
-    int rootId = hg.getESize() - 1;
-
-
-    // --- Preprocessing for lines 6 and 7. ---
-
-    // To determine which hyperedges are farther away and on which side of a
-    // separator they are, we compute pre- and post-order of the join tree.
-
-    orderPair jtDfs = joinTreeDfs(joinTree, rootId);
-
-    vector<size_t>& pre = jtDfs.first;
-    vector<size_t>& post = jtDfs.second;
-
-
-    // --- Line 2: Compute subset graph. ---
-
     // List of edges.
-    vector<intPair> ssgEdges = separatorSSG(hg, post);
-
+    vector<intPair> ssgEdges = separatorSSG(hg, postIdx);
 
-    // -- Preprocessing for line 5. ---
 
     // We later want to get the larger sets of a given set.
     // We therefore build a structure that allows to do that easily.
@@ -807,149 +923,57 @@ Graph AlphaAcyclic::unionJoinGraph(const Hypergraph& hg)
         superSets[smlId].push_back(lrgId);
     }
 
+    return superSets;
+}
 
-    // --- Line 3: Create empty union join graph. ---
-
-    vector<intPair> eList;
-    vector<int> wList; // Will all be 0.
-
-
-    // --- Line 4: Loop over all separators S. ---
-
-    for (int sId = 0; sId < hg.getESize() - 1; sId++)
-    {
-        // --- Line 5: Determine all S' with S ⊆ S' (including S). ---
-
-        const vector<int>& spList = superSets[sId];
-
-
-        // --- Line 6: For each, S' determine hyperedges it represents. ---
-        //     Line 7: Partition then based on their side of S in T.
-
-
-        // All hyperedges that are below S, i.e., descendants of S in T.
-        vector<int> downList; // bbE_1 in paper.
-
-        // All hyperedges that are above S, i.e., not descendants of S in T.
-        vector<int> aboveList; // bbE_2 in paper.
-
-
-        for (const int& spId : spList)
-        {
-            // Hyperedge below S'.
-            // The way the sparator hypergraph is created, each separator has
-            // the same ID as the hyperedge below it in the rooted join tree.
-            int chiId = spId;
-
-            // Hyperedge above S'.
-            int parId = joinTree[chiId];
-
-
-            // ----------------------------------
-            // From proof in paper:
-
-            // x is a descendant of y if and only if
-            // pre(x) > pre(y) and post(x) < post(y).
-
-            // There are four cases when determining which of E and E' to pick:
-            // 1) If S and S' represent the same edge, add E and E'.
-            // 2) If S' is a descendant of S, add the child-hyperedge.
-            // 3) If S' is an ancestor of S, add the parent-hyperedge.
-            // 4) If S' is neither an ancestor nor a descendant of S,
-            //    add the child-hyperedge.
-
-            // Clearly, one side of S contains all its descendants and the other
-            // side all remaining hyperedges and separators.
-
-            // ----------------------------------
-
-
-            // -- Determine ancestor/descendant relationship. --
-
-            // We use the ID of the hyperedge below S and S' (which give S and
-            // S' their IDs). If we would compute a pre- or post-order of T
-            // where we treat separators as their own nodes, they would be
-            // directly before (in pre-) or after (in post-) their corresponding
-            // hyperedge. Thus, we still determine ancestory correctly.
+// Computes the union join graph for a given acyclic hypergraph.
+Graph AlphaAcyclic::unionJoinGraph(const Hypergraph& hg, bool lowMemory)
+{
+    // --- Line 1: Compute join tree and separator hypergraph. ---
 
-            bool sIsDec = pre[sId] > pre[spId] && post[sId] < post[spId];
-            bool sIsAnc = pre[spId] > pre[sId] && post[spId] < post[sId];
+    vector<int> joinTree = getJoinTree(hg);
 
+    // Implementation of join tree algorithm has the result that the hyperedge
+    // with the largest ID is automatically the root.
+    int rootId = hg.getESize() - 1;
 
-            // -- Add hyperedges. --
 
-            // Case 1.
-            if (spId == sId)
-            {
-                downList.push_back(chiId);
-                aboveList.push_back(parId);
-            }
+    // --- Preprocessing for lines 6 and 7. ---
 
-            // Case 2.
-            else if (sIsAnc)
-            {
-                // S' is a descendent of S.
-                // Hence, the hyperedge below S' is farther from and below S.
-                downList.push_back(chiId);
-            }
+    // To determine which hyperedges are farther away and on which side of a
+    // separator they are, we compute pre- and post-order of the join tree.
 
-            // Case 3.
-            // Never happens. Assume we have case 3. All vertices in S would be
-            // in the hyperedge above S'. Thus, the join tree algorithm sets
-            // the hyperedge above S' as parent of the hyperedge below S.
-            else if (sIsDec)
-            {
-                // S' is an ancestor of S.
-                // Hence, the hyperedge above S' is farther from and above S.
-                aboveList.push_back(parId);
-            }
+    orderPair jtDfs = joinTreeDfs(joinTree, rootId);
 
-            // Case 4.
-            else
-            {
-                // S' is neither an ancestor nor a descendant of S.
-                // Hence, the hyperedge below S' is farther from and above S.
-                aboveList.push_back(chiId);
-            }
-        }
+    vector<size_t>& pre = jtDfs.first;
+    vector<size_t>& post = jtDfs.second;
 
 
-        // --- Line 8: Add all E_1E_2 pairs. ---
+    // --- Line 2: Compute subset graph. ---
+    //     Preprocessing for line 5.
 
-        for (const int& e1 : downList)
-        {
-            for (const int& e2 : aboveList)
-            {
-                // Ensure that from > to.
-                int fId = max(e1, e2);
-                int tId = min(e1, e2);
+    vector<vector<int>> superSets = separatorSuperSets(hg, post);
 
-                eList.push_back(sizePair(fId, tId));
-            }
-        }
-    }
 
-    Sorting::radixSort(eList);
+    // --- Lines 3 to 8: Create union join graph and add all edges. ---
 
-    // Remove duplicates.
-    if (eList.size() > 1)
-    {
-        size_t preIdx = 0;
+    vector<intPair> eList = unionJoinEdges(superSets, joinTree, pre, post, lowMemory);
 
-        for (size_t i = 1; i < eList.size(); i++)
-        {
-            intPair prev = eList[preIdx];
-            intPair curr = eList[i];
+    // The list is sorted and free of duplicates by construction.
+    return Graph(move(eList), false);
+}
 
-            if (prev == curr) continue;
+// Computes the union join graph for a given acyclic hypergraph as CSR graph.
+CsrGraph AlphaAcyclic::unionJoinCsr(const Hypergraph& hg, bool half)
+{
+    // Same as unionJoinGraph(), but the graph is built directly from the
+    // rows computed for lines 4 to 8.
 
-            preIdx++;
-            eList[preIdx] = curr;
-        }
+    vector<int> joinTree = getJoinTree(hg);
+    int rootId = hg.getESize() - 1;
 
-        eList.resize(preIdx + 1);
-    }
+    orderPair jtDfs = joinTreeDfs(joinTree, rootId);
+    vector<vector<int>> superSets = separatorSuperSets(hg, jtDfs.second);
 
-    wList.resize(eList.size(), 0);
-    return Graph(eList, wList);
+    return unionJoinCsr(hg.getESize(), superSets, joinTree, jtDfs, half);
 }
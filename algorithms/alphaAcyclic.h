@@ -4,6 +4,7 @@
 #define __Algorithms_AlphaAcyclic_H__
 
 
+#include "../dataStructures/csrGraph.h"
 #include "../dataStructures/graph.h"
 #include "../dataStructures/hypergraph.h"
 #include "subsetGraph.h"
@@ -34,10 +35,29 @@ namespace AlphaAcyclic
 
 
     // Computes the union join graph for a given acyclic hypergraph.
-    Graph unionJoinGraph(const Hypergraph& hg, SubsetGraph::ssgAlgo A);
+    // Uses the given algorithm to compute the subset graph of the separators.
+    // If lowMemory is set, duplicate edges are suppressed while generating
+    // them instead of being removed afterwards. Then, memory scales with the
+    // size of the union join graph.
+    Graph unionJoinGraph(const Hypergraph& hg, SubsetGraph::ssgStream A, bool lowMemory = false);
 
     // Computes the union join graph for a given acyclic hypergraph.
-    Graph unionJoinGraph(const Hypergraph& hg);
+    // See above for lowMemory.
+    Graph unionJoinGraph(const Hypergraph& hg, bool lowMemory = false);
+
+
+    // Computes the union join graph for a given acyclic hypergraph as CSR graph.
+    // Builds the graph directly (without edge list) and suppresses duplicate
+    // edges while generating them. If half is set, each edge is only stored
+    // at its larger endpoint.
+    CsrGraph unionJoinCsr(const Hypergraph& hg, bool half = false);
+
+    // Computes the union join graph with m vertices from the supersets of
+    // all separators (lines 4 to 8 of Algorithm 2).
+    // Each separator has the ID of the hyperedge below it in the given join
+    // tree. superSets[sId] lists all separators S' with S ⊆ S' (including S).
+    CsrGraph unionJoinCsr(size_t m, const vector<vector<int>>& superSets, const vector<int>& joinTree,
+                          const orderPair& jtDfs, bool half);
 }
 
 #endif
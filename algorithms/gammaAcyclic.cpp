@@ -135,91 +135,105 @@ Hypergraph GammaAcyclic::genrate(size_t m, size_t n)
     return Hypergraph(hg);
 }
 
-// Computes the union join graph for a given gamma-acyclic hypergraph.
-Graph GammaAcyclic::unionJoinGraph(const Hypergraph& hg)
+// Anonymous namespace with helper functions for unionJoinGraph().
+namespace
 {
-    // Lemma: An acyclic hypergraph is γ-acyclic if and only if its line graph
-    //        is isomorphic to its union join graph.
+    // Passes all edges of the union join graph of a given gamma-acyclic hypergraph to the given sink.
+    // Each edge is passed once, but in no particular order or direction.
+    void unionJoinEdges(const Hypergraph& hg, const CsrGraph::edgeSink& sink)
+    {
+        // Lemma: An acyclic hypergraph is γ-acyclic if and only if its line graph
+        //        is isomorphic to its union join graph.
 
-    // Not that the dual hypergraph H* of a gamma-acyclic hypergraph H is gamma-
-    // We can, therefore, compute L(H) = 2Sec(H*) in linear time by using the
-    // join tree of H*.
+        // Not that the dual hypergraph H* of a gamma-acyclic hypergraph H is gamma-
+        // We can, therefore, compute L(H) = 2Sec(H*) in linear time by using the
+        // join tree of H*.
 
 
-    const Hypergraph& dual = hg.getDual();
+        const Hypergraph& dual = hg.getDual();
 
-    const size_t n = dual.getVSize();
-    const size_t m = dual.getESize();
+        const size_t n = dual.getVSize();
+        const size_t m = dual.getESize();
 
 
-    // --- Compute join tree and DFS on it. ---
+        // --- Compute join tree and DFS on it. ---
 
-    vector<int> dualJoinTree = AlphaAcyclic::getJoinTree(dual);
+        vector<int> dualJoinTree = AlphaAcyclic::getJoinTree(dual);
 
-    // Determine root.
-    // The used join tree algorithm normally uses the largest ID as root.
-    // Hence we chack from the largest to thesmallest ID.
-    int rootId = -1;
-    for (rootId = m - 1; rootId >= 0 && dualJoinTree[rootId] >= 0; rootId--) { }
+        // Determine root.
+        // The used join tree algorithm normally uses the largest ID as root.
+        // Hence we chack from the largest to thesmallest ID.
+        int rootId = -1;
+        for (rootId = m - 1; rootId >= 0 && dualJoinTree[rootId] >= 0; rootId--) { }
 
-    // Run DFS.
-    vector<size_t> dfs = AlphaAcyclic::joinTreeDfs(dualJoinTree, rootId).first;
+        // Run DFS.
+        vector<size_t> dfs = AlphaAcyclic::joinTreeDfs(dualJoinTree, rootId).first;
 
-    // The computed DFS states, for a given node-ID, the index of that node in
-    // the pre-order of the tree.
-    // The following allows us to determine an ID based on an index.
+        // The computed DFS states, for a given node-ID, the index of that node in
+        // the pre-order of the tree.
+        // The following allows us to determine an ID based on an index.
 
-    vector<int> preOrder(m);
+        vector<int> preOrder(m);
 
-    for (int eId = 0; eId < m; eId++)
-    {
-        size_t eIdx = dfs[eId];
-        preOrder[eIdx] = eId;
-    }
+        for (int eId = 0; eId < m; eId++)
+        {
+            size_t eIdx = dfs[eId];
+            preOrder[eIdx] = eId;
+        }
 
 
-    // --- Compute 2-Section graph. ---
+        // --- Compute 2-Section graph. ---
 
-    vector<intPair> edgeList;
+        vector<int> oldIds;
+        vector<int> newIds;
+        vector<bool> flagged(n, false);
 
-    vector<int> oldIds;
-    vector<int> newIds;
-    vector<bool> flagged(n, false);
-
-    for (size_t i = 0; i < m; i++)
-    {
-        int eId = preOrder[i];
-        const vector<int>& vList = dual[eId];
+        for (size_t i = 0; i < m; i++)
+        {
+            int eId = preOrder[i];
+            IdSpan vList = dual[eId];
 
 
-        // Partition into new (not flagged) and old (flagged) vertices.
-        for (const int& vId : vList)
-        {
-            if (flagged[vId])
-            {
-                oldIds.push_back(vId);
-            }
-            else
+            // Partition into new (not flagged) and old (flagged) vertices.
+            for (const int& vId : vList)
             {
-                newIds.push_back(vId);
-                flagged[vId] = true;
+                if (flagged[vId])
+                {
+                    oldIds.push_back(vId);
+                }
+                else
+                {
+                    newIds.push_back(vId);
+                    flagged[vId] = true;
+                }
             }
-        }
 
-        // Connect new vertices with old vertices.
-        for (const int& nId : newIds)
-        {
-            for (const int& oId : oldIds)
+            // Connect new vertices with old vertices.
+            for (const int& nId : newIds)
             {
-                edgeList.push_back(intPair(oId, nId));
+                for (const int& oId : oldIds)
+                {
+                    sink(oId, nId);
+                }
+
+                oldIds.push_back(nId);
             }
 
-            oldIds.push_back(nId);
+            oldIds.clear();
+            newIds.clear();
         }
-
-        oldIds.clear();
-        newIds.clear();
     }
+}
+
+// Computes the union join graph for a given gamma-acyclic hypergraph.
+Graph GammaAcyclic::unionJoinGraph(const Hypergraph& hg)
+{
+    vector<intPair> edgeList;
+
+    unionJoinEdges(hg, [&edgeList](int oId, int nId)
+    {
+        edgeList.push_back(intPair(oId, nId));
+    });
 
 
     // --- Process edges to create graph. ---
@@ -234,7 +248,22 @@ Graph GammaAcyclic::unionJoinGraph(const Hypergraph& hg)
     }
 
     Sorting::radixSort(edgeList);
-    return Graph(edgeList, vector<int>(edgeList.size(), 0) /* weights */);
+    // The list is sorted and free of duplicates by construction.
+    return Graph(move(edgeList), false);
+}
+
+
+// Computes the union join graph for a given gamma-acyclic hypergraph as CSR graph.
+// If half is set, each edge is only stored at its larger endpoint.
+CsrGraph GammaAcyclic::unionJoinCsr(const Hypergraph& hg, bool half)
+{
+    // The edges are cheap to generate. Hence, we generate them twice (to
+    // count and to store them) instead of storing a list of edges.
+
+    return CsrGraph::fromEdges(hg.getESize(), [&hg](const CsrGraph::edgeSink& sink)
+    {
+        unionJoinEdges(hg, sink);
+    }, half);
 }
 
 
@@ -297,7 +326,7 @@ namespace
             {
                 dList[xId] = dist;
 
-                const vector<int>& xNeighs = onVertex ? h(xId) : h[xId];
+                IdSpan xNeighs = onVertex ? h(xId) : h[xId];
 
                 for (const int& yId : xNeighs)
                 {
@@ -458,7 +487,7 @@ namespace
         size_t& idx, // The index to start at.
         size_t& pre, // The index of the pointer to entries.
         const vector<bool>& ignore, // The removed vertices.
-        const vector<int>& neigh, // The neighbourhood to search through.
+        const IdSpan& neigh, // The neighbourhood to search through.
         vector<size_t>& next // Pointers to next entry.
     )
     {
@@ -482,8 +511,8 @@ namespace
     // Determines if two vertices are twins by comparing their neighbourhoods.
     bool checkTwins
     (
-        const vector<int>& uNei,
-        const vector<int>& vNei,
+        const IdSpan& uNei,
+        const IdSpan& vNei,
         vector<size_t>& uNext,
         vector<size_t>& vNext,
         const vector<bool>& ignore
@@ -575,7 +604,7 @@ namespace
         vector<vector<size_t>> nextLst(n + m);
         for (int xId = 0; xId < n + m; xId++)
         {
-            const vector<int>& xNeigh = xId < n ? h(xId) : h[xId - n];
+            IdSpan xNeigh = xId < n ? h(xId) : h[xId - n];
 
             vector<size_t>& xList = nextLst[xId];
             xList.resize(xNeigh.size() + 1, 0);
@@ -600,7 +629,7 @@ namespace
             const DistH::PruningType Q = prun.type;
 
             const bool xIsVer = xId < n;
-            const vector<int>& xNeigh = xIsVer ? h(xId) : h[xId - n];
+            IdSpan xNeigh = xIsVer ? h(xId) : h[xId - n];
             vector<size_t>& xNext = nextLst[xId];
 
             vector<bool>& nRemoved = xIsVer ? eRemoved : vRemoved;
@@ -772,7 +801,7 @@ vector<DistH::Pruning> GammaAcyclic::pruningSequence(const Hypergraph& h)
 
             // --- Determine downwards neighbourhood. ---
 
-            const vector<int>& xNeighs = isVLayer ? h(xId) : h[xId];
+            IdSpan xNeighs = isVLayer ? h(xId) : h[xId];
 
             vector<int> xDownN;
             for (size_t dIdx = 0; dIdx < xNeighs.size(); dIdx++)
@@ -4,6 +4,7 @@
 #define __Algorithms_GammaAcyclic_H__
 
 
+#include "../dataStructures/csrGraph.h"
 #include "../dataStructures/hypergraph.h"
 #include "distHered.h"
 
@@ -16,6 +17,10 @@ namespace GammaAcyclic
     // Computes the union join graph for a given gamma-acyclic hypergraph.
     Graph unionJoinGraph(const Hypergraph& hg);
 
+    // Computes the union join graph for a given gamma-acyclic hypergraph as CSR graph.
+    // If half is set, each edge is only stored at its larger endpoint.
+    CsrGraph unionJoinCsr(const Hypergraph& hg, bool half = false);
+
 
     // Computes a pruning sequence for a given gamma-acyclic hypergraph.
     // Returns an empty list if the given hypergraph is not gamma-acyclic.
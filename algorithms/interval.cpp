@@ -64,7 +64,7 @@ namespace
 
             // Hyperedge C in last class.
             int cId = L.last();
-            const vector<int>& cEdge = hg[cId];
+            IdSpan cEdge = hg[cId];
 
 
             // --- Line 5 ---
@@ -81,7 +81,9 @@ namespace
 
             // --- Line 6 ---
 
-            if (xIdx < cEdge.size())
+            bool found = xIdx < cEdge.size();
+
+            if (found)
             {
                 // Found an unnumbered vertex.
                 // Add it to LexBFS-order and "remove" it from C.
@@ -104,7 +106,12 @@ namespace
 
             // --- Line 8 + 9 + 10 ---
 
-            if (xId >= 0) L.refine(hg(xId));
+            // Only refine with newly numbered vertices. All classes are already
+            // either subsets of or disjoint from the hyperedges of a vertex that
+            // was numbered before. Refining with it again would not split any
+            // class, but cost d(x) each time. Without this, LexBFS is not linear.
+            // New groups are not needed. Hence, no callback.
+            if (found) L.refine(hg(xId), nullptr);
         }
 
         return idOrderPair(L.getOrder(), vLexOrder);
@@ -118,30 +125,128 @@ namespace
 
         vector<vector<int>> sepHg(m - 1);
 
-        for (size_t i = 0; i < sepHg.size(); i++)
+        // Separators are independent of each other.
+        parallelFor(sepHg.size(), 1024, [&](size_t tId, size_t fr, size_t to)
+        {
+            for (size_t i = fr; i < to; i++)
+            {
+                int lId = joinPath[i];
+                int rId = joinPath[i + 1];
+
+                IdSpan lVert = hg[lId];
+                IdSpan rVert = hg[rId];
+
+                vector<int>& sep = sepHg[i];
+
+                // Compute intersection.
+                for (size_t l = 0, r = 0; l < lVert.size() && r < rVert.size();)
+                {
+                    int lVId = lVert[l];
+                    int rVId = rVert[r];
+
+                    if (lVId <= rVId) l++;
+                    if (lVId >= rVId) r++;
+
+                    if (lVId == rVId) sep.push_back(lVId);
+                }
+            }
+        });
+
+        return sepHg;
+    }
+
+    // Determines the range of each vertex. The range of a vertex v is a pair of
+    // indices. They represent the first and last hyperedge containing v with
+    // respect to the join path. Vertices in no hyperedge have range (m, -1).
+    // Uses multiple threads.
+    vector<sizePair> vertexRanges(const Hypergraph& hg, const vector<int>& joinPath)
+    {
+        const size_t n = hg.getVSize();
+        const size_t m = hg.getESize();
+
+        // Index of each hyperedge in the join path.
+        vector<size_t> pathIdx(m);
+
+        parallelFor(m, 4096, [&](size_t tId, size_t fr, size_t to)
+        {
+            for (size_t i = fr; i < to; i++) pathIdx[joinPath[i]] = i;
+        });
+
+        // Instead of one sweep over the join path, each vertex determines the
+        // smallest and largest index of its hyperedges. Vertices are independent.
+        vector<sizePair> vRange(n, sizePair(m, -1));
+
+        parallelFor(n, 1024, [&](size_t tId, size_t fr, size_t to)
         {
-            int lId = joinPath[i];
-            int rId = joinPath[i + 1];
+            for (size_t vId = fr; vId < to; vId++)
+            {
+                IdSpan eList = hg(vId);
+                if (eList.empty()) continue;
+
+                size_t vFr = m;
+                size_t vTo = 0;
+
+                for (const int& eId : eList)
+                {
+                    vFr = min(vFr, pathIdx[eId]);
+                    vTo = max(vTo, pathIdx[eId]);
+                }
+
+                vRange[vId] = sizePair(vFr, vTo);
+            }
+        });
+
+        return vRange;
+    }
+
+    // Determines the range of each separator and the join tree of a given interval hypergraph.
+    // A separator is a subset of all separators in its range [first, second)
+    // with respect to the join path. The join tree has the first hyperedge of the path as root.
+    vector<sizePair> separatorRanges(const Hypergraph& hg, const vector<int>& joinPath, vector<int>& joinTree)
+    {
+        const size_t n = hg.getVSize();
+        const size_t m = hg.getESize();
 
-            const vector<int>& lVert = hg[lId];
-            const vector<int>& rVert = hg[rId];
+        vector<vector<int>> sepList = separators(hg, joinPath);
+        vector<sizePair> vRange = vertexRanges(hg, joinPath);
 
-            vector<int>& sep = sepHg[i];
 
-            // Compute intersection.
-            for (size_t l = 0, r = 0; l < lVert.size() && r < rVert.size();)
+        // --- Determine range of each separator. ---
+
+        vector<sizePair> sepRange(m, sizePair(0, m));
+
+        parallelFor(m - 1, 1024, [&](size_t tId, size_t fr, size_t to)
+        {
+            for (size_t i = fr; i < to; i++)
             {
-                int lVId = lVert[l];
-                int rVId = rVert[r];
+                const vector<int>& vList = sepList[i];
 
-                if (lVId <= rVId) l++;
-                if (lVId >= rVId) r++;
+                size_t& eFr = sepRange[i].first;
+                size_t& eTo = sepRange[i].second;
 
-                if (lVId == rVId) sep.push_back(lVId);
+                for (const int& vId : vList)
+                {
+                    const size_t& vFr = vRange[vId].first;
+                    const size_t& vTo = vRange[vId].second;
+
+                    eFr = max(eFr, vFr);
+                    eTo = min(eTo, vTo);
+                }
             }
+        });
+
+
+        // --- Determine join tree (i.e. parents). ---
+
+        joinTree.assign(m, -1);
+        for (size_t i = 0; i < m - 1; i++)
+        {
+            int eId = joinPath[i + 1];
+            size_t pIdx = sepRange[i].first;
+            joinTree[eId] = joinPath[pIdx];
         }
 
-        return sepHg;
+        return sepRange;
     }
 }
 
@@ -276,20 +381,44 @@ vector<int> Interval::getJoinPath(const Hypergraph& hg)
     vector<bool> eFlags(m, false);
 
     // Convert to adjacency list.
-    vector<vector<int>> tree;
-    tree.resize(m);
+    // The neighbours of E are stored in treeNei[treeOff[E]] to
+    // treeNei[treeOff[E] + treeDeg[E] - 1]. Removing a neighbour moves the
+    // last one into its place. That way, we do not need a vector per hyperedge.
+    vector<size_t> treeOff(m + 1, 0);
+    vector<size_t> treeDeg(m, 0);
+
+    for (int eId = 0; eId < m; eId++)
+    {
+        int pId = joinTree[eId];
+        if (pId == -1) continue;
+
+        treeOff[eId + 1]++;
+        treeOff[pId + 1]++;
+    }
+
+    for (size_t eId = 0; eId < m; eId++)
+    {
+        treeOff[eId + 1] += treeOff[eId];
+    }
+
+    vector<int> treeNei(treeOff[m]);
 
     for (int eId = 0; eId < m; eId++)
     {
         int pId = joinTree[eId];
         if (pId == -1) continue;
 
-        tree[eId].push_back(pId);
-        tree[pId].push_back(eId);
+        treeNei[treeOff[eId] + treeDeg[eId]++] = pId;
+        treeNei[treeOff[pId] + treeDeg[pId]++] = eId;
     }
 
 
 
+    // Set of hyperedges to process in lines 14 to 16.
+    // Reused in each iteration.
+    vector<int> C;
+
+
     // --- Line 5 ---
 
     for (auto eIt = eOrder.begin(); L.dropSingles();)
@@ -310,8 +439,7 @@ vector<int> Interval::getJoinPath(const Hypergraph& hg)
         for (; pivot.size() > 0 && processed[pivot.back()]; pivot.pop_back()) { }
 
 
-        // Set of hyperedges to process in lines 14 to 16.
-        vector<int> C;
+        C.clear();
 
 
         // --- Line 6 ---
@@ -327,7 +455,7 @@ vector<int> Interval::getJoinPath(const Hypergraph& hg)
             // --- Line 9 + 8 ---
 
             C.push_back(eId);
-            L.refine(C);
+            L.refine(C, nullptr);
         }
         else
         {
@@ -342,7 +470,8 @@ vector<int> Interval::getJoinPath(const Hypergraph& hg)
 
             // --- Line 12 + 13 ---
 
-            C = hg(xId);
+            IdSpan xEdges = hg(xId);
+            C.assign(xEdges.begin(), xEdges.end());
             L.flRefine(C);
         }
 
@@ -358,13 +487,14 @@ vector<int> Interval::getJoinPath(const Hypergraph& hg)
         {
             // Parent and neighbours of C_i.
             int& iPar = joinTree[eiId];
-            vector<int>& neighs = tree[eiId];
+            int* neighs = treeNei.data() + treeOff[eiId];
+            size_t& nCount = treeDeg[eiId];
 
             // Vertices in C_i.
-            const vector<int>& iList = hg[eiId];
+            IdSpan iList = hg[eiId];
 
             // Iterate over all neighbous of C_i to find a C_j not in C.
-            for (size_t nIdx = 0; nIdx < neighs.size(); nIdx++)
+            for (size_t nIdx = 0; nIdx < nCount; nIdx++)
             {
                 int ejId = neighs[nIdx];
                 int& jPar = joinTree[ejId];
@@ -373,8 +503,8 @@ vector<int> Interval::getJoinPath(const Hypergraph& hg)
                 if (iPar != ejId && jPar != eiId)
                 {
                     // No. Remove neighbour from list.
-                    neighs[nIdx] = neighs.back();
-                    neighs.pop_back();
+                    neighs[nIdx] = neighs[nCount - 1];
+                    nCount--;
 
                     // Next iteration.
                     nIdx--;
@@ -390,7 +520,7 @@ vector<int> Interval::getJoinPath(const Hypergraph& hg)
                 // We found a C_j not in C.
 
                 // Vertices in C_j.
-                const vector<int>& jList = hg[ejId];
+                IdSpan jList = hg[ejId];
 
                 // Add intersection of C_i and C_j onto stack (pivot).
                 for (size_t i = 0, j = 0; i < iList.size() && j < jList.size();)
@@ -410,8 +540,8 @@ vector<int> Interval::getJoinPath(const Hypergraph& hg)
                 // Remove tree edge C_iC_j ...
 
                 // ... from list.
-                neighs[nIdx] = neighs.back();
-                neighs.pop_back();
+                neighs[nIdx] = neighs[nCount - 1];
+                nCount--;
                 nIdx--;
 
                 // ... from tree.
@@ -468,6 +598,13 @@ vector<int> Interval::getJoinPath(const Hypergraph& hg)
 // Computes the edges of the subset graph of the given interval hypergraph.
 // A pair (x, y) states that y is subset of x.
 vector<intPair> Interval::subsetGraph(const Hypergraph& hg)
+{
+    return compactSubsetGraph(hg).toEdges();
+}
+
+// Computes the subset graph of the given interval hypergraph without
+// listing its edges. Needs O(m) memory.
+IntervalSubsetGraph Interval::compactSubsetGraph(const Hypergraph& hg)
 {
     vector<int> joinPath = getJoinPath(hg);
 
@@ -477,80 +614,64 @@ vector<intPair> Interval::subsetGraph(const Hypergraph& hg)
     }
 
 
-    const size_t n = hg.getVSize();
     const size_t m = hg.getESize();
 
-
-    // --- Determine range of each vertex. ---
-
-    // The range of a vertex v is a pair of indices. They represent the first
-    // and last hyperedge containing v with respect to the join path.
-
-    vector<sizePair> vRange(n, sizePair(m, -1));
-
-    for (size_t i = 0; i < m; i++)
-    {
-        int eId = joinPath[i];
-        const vector<int>& vList = hg[eId];
-
-        for (const int& vId : vList)
-        {
-            size_t& fr = vRange[vId].first;
-            size_t& to = vRange[vId].second;
-
-            fr = min(fr, i);
-            to = i /* max(to, i) is always i */;
-        }
-    }
+    vector<sizePair> vRange = vertexRanges(hg, joinPath);
 
 
     // --- Determine subset relations. ---
 
-    vector<intPair> result;
+    // All hyperedges in the range that contains all vertices of e are
+    // supersets of e. Hyperedges are independent of each other.
 
-    for (size_t i = 0; i < m; i++)
-    {
-        int eId = joinPath[i];
-        const vector<int>& vList = hg[eId];
+    vector<int> rangeFr(m);
+    vector<int> rangeTo(m);
 
-        // The range that contains all vertices of e.
-        size_t eFr = 0;
-        size_t eTo = m;
-
-        for (const int& vId : vList)
+    parallelFor(m, 1024, [&](size_t tId, size_t fr, size_t to)
+    {
+        for (size_t i = fr; i < to; i++)
         {
-            const size_t& vFr = vRange[vId].first;
-            const size_t& vTo = vRange[vId].second;
+            int eId = joinPath[i];
+            IdSpan vList = hg[eId];
 
-            eFr = max(eFr, vFr);
-            eTo = min(eTo, vTo);
-        }
+            // The range that contains all vertices of e.
+            size_t eFr = 0;
+            size_t eTo = m - 1;
 
-        // Larger hyperedges to the left.
-        for (size_t j = eFr; j < i; j++)
-        {
-            int fId = joinPath[j];
-            result.push_back(intPair(fId, eId));
-        }
+            for (const int& vId : vList)
+            {
+                const size_t& vFr = vRange[vId].first;
+                const size_t& vTo = vRange[vId].second;
 
-        // Larger hyperedges to the right.
-        for (size_t j = i + 1; j <= eTo; j++)
-        {
-            int fId = joinPath[j];
-            result.push_back(intPair(fId, eId));
+                eFr = max(eFr, vFr);
+                eTo = min(eTo, vTo);
+            }
+
+            rangeFr[eId] = eFr;
+            rangeTo[eId] = eTo;
         }
-    }
+    });
 
-    Sorting::radixSort(result);
-    return result;
+    return IntervalSubsetGraph(move(joinPath), move(rangeFr), move(rangeTo));
 }
 
 // Computes the union join graph for a given interval hypergraph.
 // A slightly optimised function that avoids some overhead.
 Graph Interval::unionJoinGraph(const Hypergraph& hg)
 {
-    // --- Determine join path and test if input is interval hypergraph. ---
+    // The rows of the CSR graph are computed in parallel and without
+    // duplicates (see AlphaAcyclic::unionJoinCsr()). With half storage, they
+    // are in the order Graph needs. Hence, the edge list is written directly
+    // to its final positions and does not need to be sorted.
+
+    CsrGraph ujg = unionJoinCsr(hg, true);
+    return Graph(ujg.toEdgeList(), false);
+}
 
+// Computes the union join graph for a given interval hypergraph as CSR graph.
+// If half is set, each edge is only stored at its larger endpoint.
+CsrGraph Interval::unionJoinCsr(const Hypergraph& hg, bool half)
+{
     vector<int> joinPath = getJoinPath(hg);
 
     if (joinPath.size() == 0)
@@ -558,227 +679,33 @@ Graph Interval::unionJoinGraph(const Hypergraph& hg)
         throw invalid_argument("Given hypergraph is not interval.");
     }
 
-
-    // ---
-
-    const size_t n = hg.getVSize();
     const size_t m = hg.getESize();
 
-    vector<vector<int>> sepList = separators(hg, joinPath);
-
-
-    // --- Determine range of each vertex. ---
-
-    // The range of a vertex v is a pair of indices. They represent the first
-    // and last hyperedge containing v with respect to the join path.
-
-    vector<sizePair> vRange(n, sizePair(m, -1));
-
-    for (size_t i = 0; i < m; i++)
-    {
-        int eId = joinPath[i];
-        const vector<int>& vList = hg[eId];
-
-        for (const int& vId : vList)
-        {
-            size_t& fr = vRange[vId].first;
-            size_t& to = vRange[vId].second;
-
-            fr = min(fr, i);
-            to = i /* max(to, i) is always i */;
-        }
-    }
-
-
-    // --- Determine range of each separator. ---
-
-    vector<sizePair> sepRange(m, sizePair(0, m));
-
-    for (size_t i = 0; i < m - 1; i++)
-    {
-        const vector<int>& vList = sepList[i];
-
-        size_t& eFr = sepRange[i].first;
-        size_t& eTo = sepRange[i].second;
-
-        for (const int& vId : vList)
-        {
-            const size_t& vFr = vRange[vId].first;
-            const size_t& vTo = vRange[vId].second;
-
-            eFr = max(eFr, vFr);
-            eTo = min(eTo, vTo);
-        }
-    }
-
-
-    // --- Determine join tree (i.e. parents). ---
-
-    vector<int> joinTree(m, -1);
-    for (size_t i = 0; i < m - 1; i++)
-    {
-        int eId = joinPath[i + 1];
-        size_t pIdx = sepRange[i].first;
-        joinTree[eId] = joinPath[pIdx];
-    }
-
-
-    // --- Preprocessing for lines 6 and 7. ---
-
-    // To determine which hyperedges are farther away and on which side of a
-    // separator they are, we compute pre- and post-order of the join tree.
+    vector<int> joinTree;
+    vector<sizePair> sepRange = separatorRanges(hg, joinPath, joinTree);
 
     AlphaAcyclic::orderPair jtDfs = AlphaAcyclic::joinTreeDfs(joinTree, joinPath[0]);
 
-    vector<size_t>& pre = jtDfs.first;
-    vector<size_t>& post = jtDfs.second;
-
-
-    // --- Line 3: Create empty union join graph. ---
 
-    vector<intPair> eList;
-    vector<int> wList; // Will all be 0.
+    // --- Preprocessing for line 5. ---
 
+    // Each separator gets the ID of the hyperedge below it (i.e., the right
+    // one in the join path). The root (first hyperedge) has no separator.
 
-    // --- Line 4: Loop over all separators S. ---
+    vector<vector<int>> superSets(m);
 
-    for (size_t i = 0; i < m - 1; i++)
+    parallelFor(m - 1, 1024, [&](size_t tId, size_t fr, size_t to)
     {
-        int sChId = joinPath[i + 1];
-
-        // --- Line 5: Determine all S' with S ⊆ S' (including S). ---
-
-        const sizePair& range = sepRange[i];
-
-
-        // --- Line 6: For each, S' determine hyperedges it represents. ---
-        //     Line 7: Partition then based on their side of S in T.
-
-
-        // All hyperedges that are below S, i.e., descendants of S in T.
-        vector<int> downList; // bbE_1 in paper.
-
-        // All hyperedges that are above S, i.e., not descendants of S in T.
-        vector<int> aboveList; // bbE_2 in paper.
-
-
-        for (size_t j = range.first; j < range.second; j++)
+        for (size_t i = fr; i < to; i++)
         {
-            // Hyperedge below S'.
-            // The way the sparator hypergraph is created, each separator has
-            // the same ID as the hyperedge below it in the rooted join tree.
-            int chiId = joinPath[j + 1];
-
-            // Hyperedge above S'.
-            int parId = joinTree[chiId];
-
-
-            // ----------------------------------
-            // From proof in paper:
-
-            // x is a descendant of y if and only if
-            // pre(x) > pre(y) and post(x) < post(y).
-
-            // There are four cases when determining which of E and E' to pick:
-            // 1) If S and S' represent the same edge, add E and E'.
-            // 2) If S' is a descendant of S, add the child-hyperedge.
-            // 3) If S' is an ancestor of S, add the parent-hyperedge.
-            // 4) If S' is neither an ancestor nor a descendant of S,
-            //    add the child-hyperedge.
-
-            // Clearly, one side of S contains all its descendants and the other
-            // side all remaining hyperedges and separators.
-
-            // ----------------------------------
-
-
-            // -- Determine ancestor/descendant relationship. --
-
-            // We use the ID of the hyperedge below S and S' (which give S and
-            // S' their IDs). If we would compute a pre- or post-order of T
-            // where we treat separators as their own nodes, they would be
-            // directly before (in pre-) or after (in post-) their corresponding
-            // hyperedge. Thus, we still determine ancestory correctly.
-
-            bool sIsDec = pre[sChId] > pre[chiId] && post[sChId] < post[chiId];
-            bool sIsAnc = pre[chiId] > pre[sChId] && post[chiId] < post[sChId];
-
-
-            // -- Add hyperedges. --
-
-            // Case 1.
-            if (chiId == sChId)
-            {
-                downList.push_back(chiId);
-                aboveList.push_back(parId);
-            }
-
-            // Case 2.
-            else if (sIsAnc)
-            {
-                // S' is a descendent of S.
-                // Hence, the hyperedge below S' is farther from and below S.
-                downList.push_back(chiId);
-            }
-
-            // Case 3.
-            // Never happens. Assume we have case 3. All vertices in S would be
-            // in the hyperedge above S'. Thus, the join tree algorithm sets
-            // the hyperedge above S' as parent of the hyperedge below S.
-            else if (sIsDec)
-            {
-                // S' is an ancestor of S.
-                // Hence, the hyperedge above S' is farther from and above S.
-                aboveList.push_back(parId);
-            }
+            vector<int>& spList = superSets[joinPath[i + 1]];
 
-            // Case 4.
-            else
+            for (size_t j = sepRange[i].first; j < sepRange[i].second; j++)
             {
-                // S' is neither an ancestor nor a descendant of S.
-                // Hence, the hyperedge below S' is farther from and above S.
-                aboveList.push_back(chiId);
+                spList.push_back(joinPath[j + 1]);
             }
         }
+    });
 
-
-        // --- Line 8: Add all E_1E_2 pairs. ---
-
-        for (const int& e1 : downList)
-        {
-            for (const int& e2 : aboveList)
-            {
-                // Ensure that from > to.
-                int fId = max(e1, e2);
-                int tId = min(e1, e2);
-
-                eList.push_back(sizePair(fId, tId));
-            }
-        }
-    }
-
-    Sorting::radixSort(eList);
-
-    // Remove duplicates.
-    if (eList.size() > 1)
-    {
-        size_t preIdx = 0;
-
-        for (size_t i = 1; i < eList.size(); i++)
-        {
-            intPair prev = eList[preIdx];
-            intPair curr = eList[i];
-
-            if (prev == curr) continue;
-
-            preIdx++;
-            eList[preIdx] = curr;
-        }
-
-        eList.resize(preIdx + 1);
-    }
-
-    wList.resize(eList.size(), 0);
-
-    return Graph(eList, wList);
+    return AlphaAcyclic::unionJoinCsr(m, superSets, joinTree, jtDfs, half);
 }
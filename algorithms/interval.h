@@ -4,7 +4,9 @@
 #define __Algorithms_Interval_H__
 
 
+#include "../dataStructures/csrGraph.h"
 #include "../dataStructures/hypergraph.h"
+#include "../dataStructures/intervalSubsetGraph.h"
 
 
 namespace Interval
@@ -21,9 +23,17 @@ namespace Interval
     // A pair (x, y) states that y is subset of x.
     vector<intPair> subsetGraph(const Hypergraph& hg);
 
+    // Computes the subset graph of the given interval hypergraph without
+    // listing its edges. Needs O(m) memory.
+    IntervalSubsetGraph compactSubsetGraph(const Hypergraph& hg);
+
     // Computes the union join graph for a given interval hypergraph.
     // A slightly optimised function that avoids some overhead.
     Graph unionJoinGraph(const Hypergraph& hg);
+
+    // Computes the union join graph for a given interval hypergraph as CSR graph.
+    // If half is set, each edge is only stored at its larger endpoint.
+    CsrGraph unionJoinCsr(const Hypergraph& hg, bool half = false);
 }
 
 #endif
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <limits>
 
 #include "../dataStructures/dijkstraHeap.h"
 #include "../dataStructures/unionFind.h"
@@ -7,7 +8,8 @@
 
 // Helper function for checkAllEdges().
 // Computes, for a given vertex u and all neighbours v, the largest minimum edge weight of all paths from u to v.
-vector<int> maxMinWeights(const Graph& g, int startId)
+// Uses the given heap, which has to be empty, and resets it afterwards. Stores the weights in result.
+void maxMinWeights(const Graph& g, int startId, DijkstraHeap& heap, vector<int>& result)
 {
     // Assume we are given a vertex u.
     // For all neighbours v, we want to compute the largest minimum edge weight of all paths from u to v.
@@ -34,8 +36,7 @@ vector<int> maxMinWeights(const Graph& g, int startId)
     // Subsequently, min_P <= wei(e) < d(v).
 
 
-    // Create heap.
-    DijkstraHeap heap(g.size());
+    // The heap only contains vertices that have been reached.
     const int* const distances = heap.getWeights();
 
     int startWei = numeric_limits<int>::max();
@@ -68,7 +69,7 @@ vector<int> maxMinWeights(const Graph& g, int startId)
 
 
     // --- Fill result. ---
-    vector<int> result;
+    result.clear();
     for (size_t i = 0; i < g[startId].size(); i++)
     {
         int vId = g[startId][i];
@@ -76,7 +77,7 @@ vector<int> maxMinWeights(const Graph& g, int startId)
         result.push_back(vDist);
     }
 
-    return result;
+    heap.reset();
 }
 
 // Determines all edges which are part of a MaxST by checking each edge individually.
@@ -119,27 +120,63 @@ vector<intPair> MstEdges::checkAllEdges(const Graph& g)
     // For each vertex u, let A[] = maxMinWeights(u).
     // For each neighbour v of u, if A[v] <= wei(uv), add uv to result.
 
+    // The searches for different u are independent. Hence, we run them in parallel.
+    // Each thread has its own heap, which is only reset for the vertices a search reached.
+    // Each block of vertices collects its edges in its own list. Concatenating them in
+    // order gives the same result as processing all vertices sequentially.
 
-    vector<intPair> result;
 
-    for (size_t uId = 0; uId < g.size(); uId++)
+    const size_t n = g.size();
+    const size_t blockSize = 16;
+    const size_t blocks = (n + blockSize - 1) / blockSize;
+
+    vector<vector<intPair>> blockResults(blocks);
+
+    // Heaps are allocated by the threads that use them.
+    vector<DijkstraHeap> heaps(threadCount());
+
+    parallelFor(n, blockSize, [&](size_t tId, size_t fr, size_t to)
     {
-        // Compute largest minimum edge weight of all paths to neighbours.
-        vector<int> mmW = maxMinWeights(g, uId);
+        DijkstraHeap& heap = heaps[tId];
+        if (heap.getWeights() == nullptr) heap.initialize(n, false);
 
-        // Compare to edge weight of each neighbour.
-        for (size_t j = 0; j < g[uId].size(); j++)
+        vector<intPair>& result = blockResults[fr / blockSize];
+        vector<int> mmW;
+
+        for (size_t uId = fr; uId < to; uId++)
         {
-            size_t vId = g[uId][j];
-            int uvWei = g(uId)[j];
+            // Compute largest minimum edge weight of all paths to neighbours.
+            maxMinWeights(g, uId, heap, mmW);
 
-            // Check if max_P min_xy wei(xy) <= w.
-            // If so, add to output if uId < vId.
-            if (mmW[j] <= uvWei && uId < vId)
+            // Compare to edge weight of each neighbour.
+            for (size_t j = 0; j < g[uId].size(); j++)
             {
-                result.push_back(sizePair(uId, vId));
+                size_t vId = g[uId][j];
+                int uvWei = g(uId)[j];
+
+                // Check if max_P min_xy wei(xy) <= w.
+                // If so, add to output if uId < vId.
+                if (mmW[j] <= uvWei && uId < vId)
+                {
+                    result.push_back(sizePair(uId, vId));
+                }
             }
         }
+    });
+
+
+    // --- Combine blocks. ---
+
+    size_t total = 0;
+    for (const vector<intPair>& list : blockResults) total += list.size();
+
+    vector<intPair> result;
+    result.reserve(total);
+
+    for (vector<intPair>& list : blockResults)
+    {
+        result.insert(result.end(), list.begin(), list.end());
+        vector<intPair>().swap(list);
     }
 
     return result;
@@ -226,21 +263,43 @@ vector<intPair> MstEdges::kruskal(const Graph& g)
     vector<intPair> result;
     vector<intPair> buffer;
 
+    // Endpoints of a chunk of edges with the current weight and their roots.
+    // No unions happen while the edges of one weight are checked. Hence, the
+    // roots of earlier chunks stay valid and the buffers only hold one chunk.
+    const size_t chunkSize = 4096;
+    vector<int> ids(2 * chunkSize);
+    vector<int> roots(2 * chunkSize);
+
     UnionFind uf(n);
 
     for (size_t ePtr = 0; ePtr < edgeList.size();)
     {
         int curWei = edgeList[ePtr].first;
 
+        // Find all edges with same weight.
+        size_t ePtrEnd = ePtr;
+        for (; ePtrEnd < edgeList.size() && curWei == edgeList[ePtrEnd].first; ePtrEnd++);
+
         // Add all edges with same weight that allow to join two sets.
-        for (; ePtr < edgeList.size() && curWei == edgeList[ePtr].first; ePtr++)
+        while (ePtr < ePtrEnd)
         {
-            int uId = edgeList[ePtr].second.first;
-            int vId = edgeList[ePtr].second.second;
+            size_t chunkEnd = min(ePtr + chunkSize, ePtrEnd);
+            size_t count = 0;
+
+            for (size_t i = ePtr; i < chunkEnd; i++)
+            {
+                ids[count++] = edgeList[i].second.first;
+                ids[count++] = edgeList[i].second.second;
+            }
+
+            uf.findSets(ids.data(), roots.data(), count);
 
-            if (uf.findSet(uId) != uf.findSet(vId))
+            for (size_t i = 0; ePtr < chunkEnd; ePtr++, i += 2)
             {
-                buffer.push_back(intPair(uId, vId));
+                if (roots[i] != roots[i + 1])
+                {
+                    buffer.push_back(edgeList[ePtr].second);
+                }
             }
         }
 
@@ -261,3 +320,166 @@ vector<intPair> MstEdges::kruskal(const Graph& g)
 
     return result;
 }
+
+// Determines all edges which are part of a MaxST by computing one MaxST (with Prim's
+// algorithm) and comparing each other edge with the smallest weight on its tree path.
+// Does not create a list of all edges. Edges are sorted and have from-ID > to-ID.
+vector<intPair> MstEdges::bottleneckTree(const Graph& g)
+{
+    // Let T be a MaxST and uv an edge with weight w not in T.
+    // Let P be the path from u to v in T and w' the smallest weight on P.
+    // Since T is a MaxST, w' >= w. Moreover, P is a path that maximises the
+    // minimum edge weight of all paths from u to v. By the theorem used in
+    // checkAllEdges(), uv is part of some MaxST if and only if w' <= w, i.e., w' == w.
+    // All edges of T are part of a MaxST.
+
+    // We root each tree of the (spanning) forest and use binary lifting:
+    // up[k][v] is the ancestor 2^k levels above v and low[k][v] the smallest
+    // weight on the path to it. The smallest weight on a path u ~> v is then
+    // found in O(log n) time while moving u and v up to their lowest common ancestor.
+
+
+    const size_t n = g.size();
+    const int Infinite = numeric_limits<int>::max();
+
+
+    // --- Compute MaxST with Prim's algorithm. ---
+
+    // parent[v] is -1 for roots. Vertices are listed in the order they are added to the tree.
+    vector<int> parent(n, -1);
+    vector<int> parWei(n, Infinite);
+    vector<int> depth(n, 0);
+    vector<int> order;
+    order.reserve(n);
+
+    vector<bool> inTree(n, false);
+
+    {
+        DijkstraHeap heap(n, false);
+        const int* const keys = heap.getWeights();
+
+        for (size_t rootId = 0; rootId < n; rootId++)
+        {
+            if (inTree[rootId]) continue;
+
+            heap.update(rootId, -Infinite); // times -1 since heap is min-heap.
+
+            while (heap.getSize() > 0)
+            {
+                int uId = heap.removeMin();
+
+                inTree[uId] = true;
+                order.push_back(uId);
+                if (parent[uId] >= 0) depth[uId] = depth[parent[uId]] + 1;
+
+                for (size_t nIdx = 0; nIdx < g[uId].size(); nIdx++)
+                {
+                    int vId = g[uId][nIdx];
+                    int uvWei = g(uId)[nIdx];
+
+                    if (inTree[vId]) continue;
+
+                    // Larger weights are better; times -1 since heap is min-heap.
+                    if (-uvWei < keys[vId])
+                    {
+                        heap.update(vId, -uvWei);
+                        parent[vId] = uId;
+                        parWei[vId] = uvWei;
+                    }
+                }
+            }
+        }
+    }
+
+
+    // --- Binary lifting. ---
+
+    size_t levels = 1;
+    while (((size_t)1 << levels) < n) levels++;
+
+    // Level k of vertex v is stored at index k * n + v.
+    vector<int> up(levels * n);
+    vector<int> low(levels * n);
+
+    for (size_t vId = 0; vId < n; vId++)
+    {
+        up[vId] = parent[vId] < 0 ? vId : parent[vId];
+        low[vId] = parWei[vId];
+    }
+
+    for (size_t k = 1; k < levels; k++)
+    {
+        const int* prevUp = up.data() + (k - 1) * n;
+        const int* prevLow = low.data() + (k - 1) * n;
+
+        for (size_t vId = 0; vId < n; vId++)
+        {
+            int midId = prevUp[vId];
+
+            up[k * n + vId] = prevUp[midId];
+            low[k * n + vId] = min(prevLow[vId], prevLow[midId]);
+        }
+    }
+
+    // Returns the smallest weight on the tree path from uId to vId.
+    // Assumes both are in the same tree.
+    auto pathMin = [&](int uId, int vId)
+    {
+        int result = Infinite;
+
+        if (depth[uId] < depth[vId]) swap(uId, vId);
+
+        // Move u up to the depth of v.
+        for (size_t k = 0, diff = depth[uId] - depth[vId]; diff > 0; k++, diff >>= 1)
+        {
+            if (diff & 1)
+            {
+                result = min(result, low[k * n + uId]);
+                uId = up[k * n + uId];
+            }
+        }
+
+        if (uId == vId) return result;
+
+        // Move both up to just below their lowest common ancestor.
+        for (size_t k = levels - 1; k < levels; k--)
+        {
+            if (up[k * n + uId] != up[k * n + vId])
+            {
+                result = min(result, min(low[k * n + uId], low[k * n + vId]));
+                uId = up[k * n + uId];
+                vId = up[k * n + vId];
+            }
+        }
+
+        return min(result, min(low[uId], low[vId]));
+    };
+
+
+    // --- Classify edges. ---
+
+    vector<intPair> result;
+
+    for (size_t uId = 0; uId < n; uId++)
+    {
+        const vector<int>& neighs = g[uId];
+        const vector<int>& weights = g(uId);
+
+        for (size_t vIdx = 0; vIdx < neighs.size(); vIdx++)
+        {
+            int vId = neighs[vIdx];
+            if (vId >= uId) break;
+
+            int uvWei = weights[vIdx];
+
+            bool isTreeEdge = parent[uId] == vId || parent[vId] == uId;
+
+            if (isTreeEdge || pathMin(uId, vId) <= uvWei)
+            {
+                result.push_back(intPair(uId, vId));
+            }
+        }
+    }
+
+    return result;
+}
@@ -21,6 +21,11 @@ namespace MstEdges
 
     // Determines all edges which are part of a MaxST based on Kruskal's algorithm.
     vector<intPair> kruskal(const Graph& g);
+
+    // Determines all edges which are part of a MaxST by computing one MaxST (with Prim's
+    // algorithm) and comparing each other edge with the smallest weight on its tree path.
+    // Does not create a list of all edges. Edges are sorted and have from-ID > to-ID.
+    vector<intPair> bottleneckTree(const Graph& g);
 }
 
 #endif
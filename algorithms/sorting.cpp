@@ -1,4 +1,6 @@
 #include <algorithm>
+#include <cstdint>
+#include <cstdlib>
 
 #include "sorting.h"
 
@@ -30,12 +32,250 @@ vector<intPair>* Sorting::ensureSorting(const vector<intPair>& vec)
 // Checks if the given vector is sorted and sorts it if not.
 void Sorting::ensureSorting(vector<intPair>& vec)
 {
-    if (isSorted(vec)) Sorting::radixSort(vec);
+    if (!isSorted(vec)) Sorting::radixSort(vec);
 }
 
 
+namespace
+{
+    // Determines if all values of the given pairs are in [0, 2N). Then, the
+    // counts of radixSortSimple() are not larger than the list itself.
+    bool smallValues(const vector<intPair>& pairs)
+    {
+        const int64_t limit = 2 * (int64_t)pairs.size();
+
+        for (const intPair& p : pairs)
+        {
+            if (p.first < 0 || p.second < 0 || p.first >= limit || p.second >= limit) return false;
+        }
+
+        return true;
+    }
+}
+
 // Sorts a set of integer pairs using radix sort.
+// Sorts packed 64-bit keys with multiple threads.
+// Small lists with small values are sorted with radixSortSimple().
 void Sorting::radixSort(vector<intPair>& pairs)
+{
+    // We pack each pair into a 64-bit key such that keys have the same order
+    // as pairs. Then, we run an LSD radix sort on the keys:
+    //   - Each pass sorts by one digit of at most 11 bits. Only as many
+    //     passes as needed for the largest key are done.
+    //   - The list is split into one part per thread. Each part has its own
+    //     histogram. Hence, threads can count and scatter independently and
+    //     the sort stays stable.
+    //   - Threads do not write keys directly to their bucket. They collect
+    //     keys in a small buffer (one cache line) per bucket and copy full
+    //     buffers at once (software write-combining). That avoids touching
+    //     up to 2048 different cache lines in random order.
+
+    const size_t N = pairs.size();
+
+    // Small lists: packing is not worth it. Two counting sorts are faster as
+    // long as the key pass of a single thread is not (measured: up to about
+    // 2^19 pairs). Lists with less than 2^15 pairs are not split anyway.
+    const size_t crossover = threadCount() == 1 ? (1 << 19) : (1 << 15);
+
+    if (N < crossover)
+    {
+        if (smallValues(pairs))
+        {
+            radixSortSimple(pairs);
+            return;
+        }
+
+        if (N < (1 << 14))
+        {
+            sort(pairs.begin(), pairs.end());
+            return;
+        }
+    }
+
+
+    // --- Determine key size. ---
+
+    const size_t parts = min(threadCount(), N / (1 << 14));
+    const size_t partSize = (N + parts - 1) / parts;
+
+    // Range of values in each dimension. Per part, then combined.
+    vector<intPair> minVal(parts, MaxIntPair);
+    vector<intPair> maxVal(parts, intPair(numeric_limits<int>::min(), numeric_limits<int>::min()));
+
+    parallelFor(parts, 1, [&](size_t tId, size_t fr, size_t to)
+    {
+        for (size_t p = fr; p < to; p++)
+        {
+            for (size_t i = p * partSize; i < min(N, (p + 1) * partSize); i++)
+            {
+                minVal[p].first = min(minVal[p].first, pairs[i].first);
+                minVal[p].second = min(minVal[p].second, pairs[i].second);
+                maxVal[p].first = max(maxVal[p].first, pairs[i].first);
+                maxVal[p].second = max(maxVal[p].second, pairs[i].second);
+            }
+        }
+    });
+
+    for (size_t p = 1; p < parts; p++)
+    {
+        minVal[0].first = min(minVal[0].first, minVal[p].first);
+        minVal[0].second = min(minVal[0].second, minVal[p].second);
+        maxVal[0].first = max(maxVal[0].first, maxVal[p].first);
+        maxVal[0].second = max(maxVal[0].second, maxVal[p].second);
+    }
+
+    // Keys store values relative to the minimum. That way, the key only has
+    // as many bits as needed.
+    const int64_t minF = minVal[0].first;
+    const int64_t minS = minVal[0].second;
+
+    // Number of bits needed for each dimension.
+    auto bitsFor = [](uint64_t x) -> unsigned { return x == 0 ? 0 : 64 - __builtin_clzll(x); };
+
+    const unsigned bitsS = bitsFor(maxVal[0].second - minS);
+    const unsigned bits = bitsS + bitsFor(maxVal[0].first - minF);
+
+    // Distribute bits evenly among passes; at most 11 bits per digit.
+    const unsigned passes = (bits + 10) / 11;
+    const unsigned digitBits = passes == 0 ? 0 : (bits + passes - 1) / passes;
+    const size_t buckets = (size_t)1 << digitBits;
+    const uint64_t digitMask = buckets - 1;
+
+
+    // --- Pack pairs into keys. ---
+
+    // Keys are stored in place of the pairs (both use 8 bytes).
+    static_assert(sizeof(intPair) == sizeof(uint64_t), "Pairs and keys have to be the same size.");
+
+    uint64_t* keys = reinterpret_cast<uint64_t*>(pairs.data());
+    uint64_t* buffer = new uint64_t[N];
+
+    parallelFor(N, 1 << 16, [&](size_t tId, size_t fr, size_t to)
+    {
+        for (size_t i = fr; i < to; i++)
+        {
+            intPair p = pairs[i];
+            keys[i] = ((uint64_t)(p.first - minF) << bitsS) | (uint64_t)(p.second - minS);
+        }
+    });
+
+
+    // --- Sort by each digit. ---
+
+    // Histograms and write positions of all parts.
+    vector<size_t> counts(parts * buckets);
+
+    // Number of keys per write-combining buffer (one cache line).
+    const size_t WcSize = 64 / sizeof(uint64_t);
+
+    uint64_t* src = keys;
+    uint64_t* dst = buffer;
+
+    for (unsigned pass = 0; pass < passes; pass++)
+    {
+        const unsigned shift = pass * digitBits;
+
+        // Count.
+        parallelFor(parts, 1, [&](size_t tId, size_t fr, size_t to)
+        {
+            for (size_t p = fr; p < to; p++)
+            {
+                size_t* count = counts.data() + p * buckets;
+                fill(count, count + buckets, 0);
+
+                for (size_t i = p * partSize; i < min(N, (p + 1) * partSize); i++)
+                {
+                    count[(src[i] >> shift) & digitMask]++;
+                }
+            }
+        });
+
+        // Prefix sums. Order by bucket, then by part (keeps the sort stable).
+        size_t sum = 0;
+        bool trivial = false;
+
+        for (size_t b = 0; b < buckets; b++)
+        {
+            size_t bucketStart = sum;
+
+            for (size_t p = 0; p < parts; p++)
+            {
+                size_t c = counts[p * buckets + b];
+                counts[p * buckets + b] = sum;
+                sum += c;
+            }
+
+            trivial = trivial || (sum - bucketStart == N);
+        }
+
+        // All keys have the same digit. Nothing to do.
+        if (trivial) continue;
+
+        // Scatter.
+        parallelFor(parts, 1, [&](size_t tId, size_t fr, size_t to)
+        {
+            // Aligned to cache lines.
+            uint64_t* wcBuffer = (uint64_t*)aligned_alloc(64, buckets * WcSize * sizeof(uint64_t));
+            vector<unsigned char> wcFill(buckets, 0);
+
+            for (size_t p = fr; p < to; p++)
+            {
+                size_t* next = counts.data() + p * buckets;
+
+                for (size_t i = p * partSize; i < min(N, (p + 1) * partSize); i++)
+                {
+                    uint64_t key = src[i];
+                    size_t b = (key >> shift) & digitMask;
+
+                    uint64_t* wc = wcBuffer + b * WcSize;
+                    wc[wcFill[b]] = key;
+                    wcFill[b]++;
+
+                    if (wcFill[b] == WcSize)
+                    {
+                        copy(wc, wc + WcSize, dst + next[b]);
+                        next[b] += WcSize;
+                        wcFill[b] = 0;
+                    }
+                }
+
+                // Flush remaining keys.
+                for (size_t b = 0; b < buckets; b++)
+                {
+                    uint64_t* wc = wcBuffer + b * WcSize;
+                    copy(wc, wc + wcFill[b], dst + next[b]);
+                    next[b] += wcFill[b];
+                    wcFill[b] = 0;
+                }
+            }
+
+            free(wcBuffer);
+        });
+
+        swap(src, dst);
+    }
+
+
+    // --- Unpack keys. ---
+
+    const uint64_t maskS = bitsS == 0 ? 0 : ((uint64_t)-1 >> (64 - bitsS));
+
+    parallelFor(N, 1 << 16, [&](size_t tId, size_t fr, size_t to)
+    {
+        for (size_t i = fr; i < to; i++)
+        {
+            uint64_t key = src[i];
+            pairs[i] = intPair((int)((key >> bitsS) + minF), (int)((key & maskS) + minS));
+        }
+    });
+
+    delete[] buffer;
+}
+
+// Sorts a set of integer pairs using radix sort.
+// Uses two counting sorts (one per dimension) with a single thread.
+// Requires non-negative values. radixSort() uses it for small lists.
+void Sorting::radixSortSimple(vector<intPair>& pairs)
 {
     // --- Counting sort on second dimension. ---
 
@@ -97,6 +337,61 @@ void Sorting::radixSort(vector<intPair>& pairs)
     }
 }
 
+// Sorts a set of integer pairs and removes duplicates.
+// Uses radixSort() and removes duplicates with multiple threads.
+void Sorting::sortUnique(vector<intPair>& pairs)
+{
+    radixSort(pairs);
+
+    // A pair is kept if it differs from its predecessor. Each part counts its
+    // kept pairs first. With the prefix sums of these counts, every part
+    // knows where to write and can copy independently.
+
+    const size_t N = pairs.size();
+    const size_t parts = max((size_t)1, min(threadCount(), N / (1 << 14)));
+    const size_t partSize = (N + parts - 1) / parts;
+
+    vector<size_t> starts(parts + 1, 0);
+
+    parallelFor(parts, 1, [&](size_t tId, size_t fr, size_t to)
+    {
+        for (size_t p = fr; p < to; p++)
+        {
+            size_t count = 0;
+            for (size_t i = p * partSize; i < min(N, (p + 1) * partSize); i++)
+            {
+                if (i == 0 || pairs[i] != pairs[i - 1]) count++;
+            }
+            starts[p + 1] = count;
+        }
+    });
+
+    for (size_t p = 0; p < parts; p++)
+    {
+        starts[p + 1] += starts[p];
+    }
+
+    // Nothing to remove.
+    if (starts[parts] == N) return;
+
+    // Writing in place could overwrite pairs another part has not read yet.
+    vector<intPair> result(starts[parts]);
+
+    parallelFor(parts, 1, [&](size_t tId, size_t fr, size_t to)
+    {
+        for (size_t p = fr; p < to; p++)
+        {
+            size_t idx = starts[p];
+            for (size_t i = p * partSize; i < min(N, (p + 1) * partSize); i++)
+            {
+                if (i == 0 || pairs[i] != pairs[i - 1]) result[idx++] = pairs[i];
+            }
+        }
+    });
+
+    pairs.swap(result);
+}
+
 // Lexicographically sorts the given list of vectors.
 // Returns an array A[] such that A[i] is the ID of the vector which is at position i in a lex. order.
 size_t* Sorting::lexSort(const vector<vector<int>>& lst)
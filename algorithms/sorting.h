@@ -22,8 +22,19 @@ namespace Sorting
 
 
     // Sorts a set of integer pairs using radix sort.
+    // Sorts packed 64-bit keys with multiple threads.
+    // Small lists with small values are sorted with radixSortSimple().
     void radixSort(vector<intPair>& pairs);
 
+    // Sorts a set of integer pairs using radix sort.
+    // Uses two counting sorts (one per dimension) with a single thread.
+    // Requires non-negative values. radixSort() uses it for small lists.
+    void radixSortSimple(vector<intPair>& pairs);
+
+    // Sorts a set of integer pairs and removes duplicates.
+    // Uses radixSort() and removes duplicates with multiple threads.
+    void sortUnique(vector<intPair>& pairs);
+
     // Lexicographically sorts the given list of vectors.
     // Returns an array A[] such that A[i] is the ID of the vector which is at position i in a lex. order.
     size_t* lexSort(const vector<vector<int>>& lst);
@@ -1,3 +1,4 @@
+#include <mutex>
 #include <stdexcept>
 
 #include "../dataStructures/reducedSet.h"
@@ -6,19 +7,41 @@
 #include "subsetGraph.h"
 
 
+// Runs the given algorithm and collects all edges in a list.
+// If sorted is false, edges are in the order in which the algorithm finds them.
+vector<intPair> SubsetGraph::collect(const Hypergraph& hg, ssgStream algo, bool sorted)
+{
+    vector<intPair> result;
+
+    algo(hg, [&result](int xId, int yId)
+    {
+        result.push_back(intPair(xId, yId));
+    });
+
+    if (sorted) Sorting::radixSort(result);
+    return result;
+}
+
+
 // Implements a naive approach to find all subset relations (compairs all pairs of hyperedges).
 vector<intPair> SubsetGraph::naive(const Hypergraph& hg)
+{
+    return collect(hg, naive, true);
+}
+
+// Implements a naive approach to find all subset relations (compairs all pairs of hyperedges).
+// Sends the edges to the given sink.
+void SubsetGraph::naive(const Hypergraph& hg, const edgeSink& sink)
 {
     int m = hg.getESize();
-    vector<intPair> answer;
 
     for (int i = 0; i < m; i++)
     {
-        const vector<int>& iSet = hg[i];
+        IdSpan iSet = hg[i];
 
         for (int j = i + 1; j < m; j++)
         {
-            const vector<int>& jSet = hg[j];
+            IdSpan jSet = hg[j];
 
             bool iSubsetJ = true;
             bool jSubsetI = true;
@@ -51,18 +74,22 @@ vector<intPair> SubsetGraph::naive(const Hypergraph& hg)
                 if (vI >= vJ) pJ++;
             }
 
-            if (iSubsetJ) answer.push_back(intPair(j, i));
-            if (jSubsetI) answer.push_back(intPair(i, j));
+            if (iSubsetJ) sink(j, i);
+            if (jSubsetI) sink(i, j);
         }
     }
-
-    Sorting::radixSort(answer);
-    return answer;
 }
 
 
 // Implements Pritchard's "simple" algorithm as published in Algorithmica 1999.
 vector<intPair> SubsetGraph::pritchardSimple(const Hypergraph& hg)
+{
+    return collect(hg, pritchardSimple, true);
+}
+
+// Implements Pritchard's "simple" algorithm as published in Algorithmica 1999.
+// Sends the edges to the given sink.
+void SubsetGraph::pritchardSimple(const Hypergraph& hg, const edgeSink& sink)
 {
     // Pritchard assumes for their algorithm that there are no two equal sets.
     // For now, we do not address that problem. If needed, we simplify the hypergraph later.
@@ -94,11 +121,9 @@ vector<intPair> SubsetGraph::pritchardSimple(const Hypergraph& hg)
 
     // --- Step 3) ---
 
-    vector<intPair> result;
-
     for (int yId = 0; yId < hg.getESize(); yId++)
     {
-        const vector<int>& vertices = hg[yId];
+        IdSpan vertices = hg[yId];
         if (vertices.size() <= 0) throw std::invalid_argument("Invalid hypergraph.");
 
         // Compute F.y using the following relation:
@@ -106,13 +131,13 @@ vector<intPair> SubsetGraph::pritchardSimple(const Hypergraph& hg)
 
 
         // Initialise intersection with hyperedges of "first" vertex.
-        vector<int> intersection(hg(vertices[0]));
+        vector<int> intersection = hg(vertices[0]).toVector();
 
         // Intersect with hyperedges of all other vertices.
         for (int vIdx = 1 /* 0 done above */; vIdx < vertices.size(); vIdx++)
         {
             int vId = vertices[vIdx];
-            const vector<int>& vEdges = hg(vId);
+            IdSpan vEdges = hg(vId);
 
             int newSize = 0;
             for (int i = 0, j = 0; i < intersection.size() && j < vEdges.size();)
@@ -133,22 +158,37 @@ vector<intPair> SubsetGraph::pritchardSimple(const Hypergraph& hg)
             intersection.resize(newSize);
         }
 
-        // Intersection calculated. Add edges to result.
+        // Intersection calculated. Send edges to sink.
         for (int i = 0; i < intersection.size(); i++)
         {
             int xId = intersection[i];
             if (xId == yId) continue;
 
-            result.push_back(intPair(xId, yId));
+            sink(xId, yId);
         }
     }
-
-    Sorting::radixSort(result);
-    return result;
 }
 
 // Implements Pritchard's algorithm with reduced sets.
+// Sets of vertices in many hyperedges are stored dense.
 vector<intPair> SubsetGraph::pritchardReduced(const Hypergraph& hg)
+{
+    return collect(hg, pritchardReduced, true);
+}
+
+// Implements Pritchard's algorithm with reduced sets.
+// Sets of vertices in many hyperedges are stored dense.
+// Sends the edges to the given sink.
+void SubsetGraph::pritchardReduced(const Hypergraph& hg, const edgeSink& sink)
+{
+    pritchardReduced(hg, true, nullptr, sink);
+}
+
+// Implements Pritchard's algorithm with reduced sets.
+// If adaptive is true, each set is stored dense if that needs less memory.
+// Otherwise, all sets are stored reduced. Fills stats if given.
+// Sends the edges to the given sink.
+void SubsetGraph::pritchardReduced(const Hypergraph& hg, bool adaptive, FormatStats* stats, const edgeSink& sink)
 {
     // Pritchard assumes for their algorithm that there are no two equal sets.
     // For now, we do not address that problem. If needed, we simplify the hypergraph later.
@@ -183,20 +223,43 @@ vector<intPair> SubsetGraph::pritchardReduced(const Hypergraph& hg)
     const int n = hg.getVSize();
     const int m = hg.getESize();
 
+    // Vertices in most hyperedges have sets with few zero words. Storing them
+    // dense avoids the indices of reduced sets.
+    ReducedSet::Format format = adaptive ? ReducedSet::Format::Auto : ReducedSet::Format::Reduced;
+
     ReducedSet vSets[n];
     for (int vId = 0; vId < n; vId++)
     {
-        vSets[vId] = ReducedSet(hg(vId));
+        vSets[vId] = ReducedSet(hg(vId), format);
     }
 
+    if (stats != nullptr)
+    {
+        *stats = FormatStats();
 
-    // --- Step 3) ---
+        for (int vId = 0; vId < n; vId++)
+        {
+            const ReducedSet& set = vSets[vId];
 
-    vector<intPair> result;
+            if (set.isDense())
+            {
+                stats->denseSets++;
+                stats->denseWords += set.storedWords();
+            }
+            else
+            {
+                stats->reducedSets++;
+                stats->reducedWords += set.storedWords();
+            }
+        }
+    }
+
+
+    // --- Step 3) ---
 
     for (int yId = 0; yId < m; yId++)
     {
-        const vector<int>& vertices = hg[yId];
+        IdSpan vertices = hg[yId];
         if (vertices.size() <= 0) throw std::invalid_argument("Invalid hypergraph.");
 
         // Compute F.y using the following relation:
@@ -204,31 +267,137 @@ vector<intPair> SubsetGraph::pritchardReduced(const Hypergraph& hg)
 
 
         // Initialise intersection with hyperedges of "first" vertex.
-        ReducedSet intersection(vSets[vertices[0]]);
+        // Prefer a reduced set. The intersection then stays reduced and is
+        // updated in place (intersecting a dense set with a reduced one
+        // creates a new set).
+        int first = 0;
+        while (first < vertices.size() && vSets[vertices[first]].isDense()) first++;
+        if (first == vertices.size()) first = 0;
+
+        ReducedSet intersection(vSets[vertices[first]]);
 
         // Intersect with hyperedges of all other vertices.
-        for (int vIdx = 1 /* 0 done above */; vIdx < vertices.size(); vIdx++)
+        for (int vIdx = 0; vIdx < vertices.size(); vIdx++)
         {
+            if (vIdx == first) continue; // Done above.
+
             int vId = vertices[vIdx];
             intersection &= vSets[vId];
         }
 
-        // Intersection calculated. Add edges to result.
+        // Intersection calculated. Send edges to sink.
         for (auto it = intersection.begin(); it != intersection.end(); ++it)
         {
             int xId = *it;
             if (xId == yId) continue;
 
-            result.push_back(intPair(xId, yId));
+            sink(xId, yId);
         }
     }
+}
 
-    Sorting::radixSort(result);
-    return result;
+// Implements Pritchard's algorithm with reduced sets.
+// Processes blocks of hyperedges in parallel.
+vector<intPair> SubsetGraph::pritchardParallel(const Hypergraph& hg)
+{
+    return collect(hg, pritchardParallel, true);
+}
+
+// Implements Pritchard's algorithm with reduced sets.
+// Processes blocks of hyperedges in parallel.
+// Sends the edges to the given sink. Only one thread calls the sink at a time.
+void SubsetGraph::pritchardParallel(const Hypergraph& hg, const edgeSink& sink)
+{
+    // Same approach as pritchardReduced(). The intersections in Step 3 are
+    // independent of each other. We therefore split the hyperedges into blocks
+    // and let multiple threads process them. Each thread writes the edges of
+    // a block into its own buffer and sends them to the sink afterwards.
+
+
+    // --- Step 2)  Create reduced sets for each vertex. ---
+
+    const int n = hg.getVSize();
+    const int m = hg.getESize();
+
+    vector<ReducedSet> vSets(n);
+
+    parallelFor(n, 1024, [&](size_t tId, size_t fr, size_t to)
+    {
+        for (size_t vId = fr; vId < to; vId++)
+        {
+            vSets[vId] = ReducedSet(hg(vId));
+        }
+    });
+
+
+    // --- Step 3) ---
+
+    // Check input first. Exceptions cannot leave a thread.
+    for (int yId = 0; yId < m; yId++)
+    {
+        if (hg[yId].size() <= 0) throw std::invalid_argument("Invalid hypergraph.");
+    }
+
+    // One result buffer per thread.
+    vector<vector<intPair>> buffers(threadCount());
+
+    // Ensures that only one thread calls the sink at a time.
+    mutex sinkMutex;
+
+    // Small blocks keep threads busy if hyperedges differ a lot in size.
+    parallelFor(m, 256, [&](size_t tId, size_t fr, size_t to)
+    {
+        vector<intPair>& result = buffers[tId];
+
+        for (int yId = fr; yId < to; yId++)
+        {
+            IdSpan vertices = hg[yId];
+
+            // Compute F.y using the following relation:
+            // F.y = \bigcup_{d \in y} F.{d}
+
+
+            // Initialise intersection with hyperedges of "first" vertex.
+            ReducedSet intersection(vSets[vertices[0]]);
+
+            // Intersect with hyperedges of all other vertices.
+            for (int vIdx = 1 /* 0 done above */; vIdx < vertices.size(); vIdx++)
+            {
+                int vId = vertices[vIdx];
+                intersection &= vSets[vId];
+            }
+
+            // Intersection calculated. Add edges to result.
+            for (auto it = intersection.begin(); it != intersection.end(); ++it)
+            {
+                int xId = *it;
+                if (xId == yId) continue;
+
+                result.push_back(intPair(xId, yId));
+            }
+        }
+
+        // Send edges of the block to sink. The buffer is reused for the next block.
+        lock_guard<mutex> lock(sinkMutex);
+
+        for (const intPair& edge : result)
+        {
+            sink(edge.first, edge.second);
+        }
+
+        result.clear();
+    });
 }
 
 // Implements Pritchard's algorithm with presorted hyperedges.
 vector<intPair> SubsetGraph::pritchardRefinement(const Hypergraph& hg)
+{
+    return collect(hg, pritchardRefinement, true);
+}
+
+// Implements Pritchard's algorithm with presorted hyperedges.
+// Sends the edges to the given sink.
+void SubsetGraph::pritchardRefinement(const Hypergraph& hg, const edgeSink& sink)
 {
     // Pritchard assumes for their algorithm that there are no two equal sets.
     // For now, we do not address that problem. If needed, we simplify the hypergraph later.
@@ -314,7 +483,7 @@ vector<intPair> SubsetGraph::pritchardRefinement(const Hypergraph& hg)
     for (int voIdx = 0; voIdx < n; voIdx++)
     {
         int vId = vWeiOrder[voIdx];
-        const vector<int>& vHypEdges = hg(vId);
+        IdSpan vHypEdges = hg(vId);
 
         for (int eId : vHypEdges)
         {
@@ -343,7 +512,7 @@ vector<intPair> SubsetGraph::pritchardRefinement(const Hypergraph& hg)
     for (int eoIdx = 0; eoIdx < m; eoIdx++)
     {
         int eId = eLexOrder[eoIdx];
-        const vector<int>& eVerts = hg[eId];
+        IdSpan eVerts = hg[eId];
 
         for (int vId : eVerts)
         {
@@ -370,9 +539,11 @@ vector<intPair> SubsetGraph::pritchardRefinement(const Hypergraph& hg)
 
     // --- Step 3) ---
 
-    vector<intPair> result;
-    vector<ReducedSet> history;
-    history.push_back(ReducedSet());
+    // The history of intersections. The i-th set is the intersection of the
+    // F.{d} for the first i + 1 vertices d of the current hyperedge.
+    // Stored in one buffer. Hence, removing old intersections and adding new
+    // ones does not allocate memory once the buffer is large enough.
+    ReducedSet::Stack history;
 
     for (int eoIdx = 0, sucShared = 0; eoIdx < m; eoIdx++)
     {
@@ -423,17 +594,13 @@ vector<intPair> SubsetGraph::pritchardRefinement(const Hypergraph& hg)
 
         // --- Initialise intersection with hyperedges of "first" vertex. ---
 
-        ReducedSet intersection;
+        // Only keep the intersections shared with the previous hyperedge.
+        history.resize(shared);
 
-        if (shared > 0)
-        {
-            intersection = history[shared - 1];
-        }
-        else
+        if (shared == 0)
         {
             int v0_woIdx = yVertIdxs[0]; // Index after sorting by weight.
-            intersection = ReducedSet(vSets[v0_woIdx]);
-            history[0] = intersection;
+            history.push(vSets[v0_woIdx]);
         }
 
 
@@ -441,29 +608,24 @@ vector<intPair> SubsetGraph::pritchardRefinement(const Hypergraph& hg)
         for (int i = max(shared, 1) /* previous done above */; i < ySize; i++)
         {
             int vIdx = yVertIdxs[i];
-            intersection &= vSets[vIdx];
 
-            if (i < sucShared)
-            {
-                if (i >= history.size()) history.push_back(intersection);
-                else history[i] = intersection;
-            }
+            // Keep the previous intersection if the next hyperedge needs it.
+            // Otherwise, we can overwrite it.
+            if (i - 1 < sucShared) history.pushIntersection(vSets[vIdx]);
+            else history.intersectTop(vSets[vIdx]);
         }
 
-        // Intersection calculated. Add edges to result.
-        for (auto it = intersection.begin(); it != intersection.end(); ++it)
+        // Intersection calculated. Send edges to sink.
+        for (auto it = history.begin(); it != history.end(); ++it)
         {
             int x_eoIdx = *it;
             int xId = eLexOrder[x_eoIdx];
             if (xId == yId) continue;
 
-            result.push_back(intPair(xId, yId));
+            sink(xId, yId);
         }
     }
 
 
     delete[] eLexOrder;
-
-    Sorting::radixSort(result);
-    return result;
 }
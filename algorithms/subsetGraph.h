@@ -3,6 +3,7 @@
 #ifndef __Algorithms_SubsetGraph_H__
 #define __Algorithms_SubsetGraph_H__
 
+#include <functional>
 #include <vector>
 
 #include "../helper.h"
@@ -14,19 +15,73 @@ namespace SubsetGraph
     // A reference to a function that computes the subset graph of a given hypergraph.
     typedef vector<intPair> (&ssgAlgo)(const Hypergraph&);
 
+    // Receives the edges of a subset graph one at a time.
+    // An edge (x, y) states that hyperedge y is a subset of hyperedge x.
+    typedef function<void(int, int)> edgeSink;
+
+    // A reference to a function that sends the subset graph of a given
+    // hypergraph to a sink. Edges are not sorted.
+    typedef void (&ssgStream)(const Hypergraph&, const edgeSink&);
+
+    // Creates a sink that writes edges into an output iterator (e.g., a back_inserter).
+    template <class OutputIt>
+    edgeSink iteratorSink(OutputIt out)
+    {
+        return [out](int xId, int yId) mutable { *out++ = intPair(xId, yId); };
+    }
+
+
+    // Statistics about how the sets F.{d} of vertices are stored.
+    struct FormatStats
+    {
+        // The number of sets stored reduced and dense.
+        size_t reducedSets = 0;
+        size_t denseSets = 0;
+
+        // The number of words stored by reduced and dense sets.
+        size_t reducedWords = 0;
+        size_t denseWords = 0;
+    };
+
+
+    // Runs the given algorithm and collects all edges in a list.
+    // If sorted is false, edges are in the order in which the algorithm finds them.
+    vector<intPair> collect(const Hypergraph& hg, ssgStream algo, bool sorted);
+
+
+    // The functions below return the subset graph as sorted list of edges.
+    // Their overloads with a sink send each edge to the sink instead (in the
+    // order they are found). That way, callers do not have to store all edges.
+
 
     // Implements a naive approach to find all subset relations (compairs all pairs of hyperedges).
     vector<intPair> naive(const Hypergraph& hg);
+    void naive(const Hypergraph& hg, const edgeSink& sink);
 
 
     // Implements Pritchard's "simple" algorithm as published in Algorithmica 1999.
     vector<intPair> pritchardSimple(const Hypergraph& hg);
+    void pritchardSimple(const Hypergraph& hg, const edgeSink& sink);
 
     // Implements Pritchard's algorithm with reduced sets.
+    // Sets of vertices in many hyperedges are stored dense.
     vector<intPair> pritchardReduced(const Hypergraph& hg);
+    void pritchardReduced(const Hypergraph& hg, const edgeSink& sink);
+
+    // Implements Pritchard's algorithm with reduced sets.
+    // If adaptive is true, each set is stored dense if that needs less memory.
+    // Otherwise, all sets are stored reduced. Fills stats if given.
+    void pritchardReduced(const Hypergraph& hg, bool adaptive, FormatStats* stats, const edgeSink& sink);
+
+    // Implements Pritchard's algorithm with reduced sets.
+    // Processes blocks of hyperedges in parallel.
+    // The sink is called by one thread at a time and should not throw.
+    vector<intPair> pritchardParallel(const Hypergraph& hg);
+    void pritchardParallel(const Hypergraph& hg, const edgeSink& sink);
 
     // Implements Pritchard's algorithm with presorted hyperedges.
     vector<intPair> pritchardRefinement(const Hypergraph& hg);
+    void pritchardRefinement(const Hypergraph& hg, const edgeSink& sink);
 }
 
 #endif
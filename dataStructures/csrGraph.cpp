@@ -0,0 +1,500 @@
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+#include "csrGraph.h"
+
+
+// Default constructor.
+// Creates an empty graph.
+CsrGraph::CsrGraph()
+{
+    allocate(0, 0, false);
+}
+
+// Constructor.
+// Needs to be sorted by vertex-IDs, not contain duplicates, and from-ID >= to-ID.
+// Pairs with from-ID == to-ID are not added as edges (allows isolated vertices).
+CsrGraph::CsrGraph(const vector<intPair>& eList, const vector<int>& wList, bool half)
+{
+    // --- Verify input. ---
+
+    // Equal length?
+    if (eList.size() != wList.size())
+    {
+        throw logic_error("Size of given listst not equal.");
+    }
+
+    for (size_t i = 0; i < eList.size(); i++)
+    {
+        // from-ID > to-ID?
+        if (eList[i].first < eList[i].second)
+        {
+            throw logic_error("From-ID < to-ID.");
+        }
+
+        // Sorted, no duplicates?
+        if (i > 0 && eList[i - 1] >= eList[i])
+        {
+            throw logic_error("List not sorted or contains duplicates.");
+        }
+    }
+
+
+    // --- Build graph. ---
+
+    // The list is already sorted by the larger endpoint. Hence, it directly
+    // gives the rows for half storage.
+
+    // Due to order and from-ID > to-ID, largest ID is from-ID at the very end.
+    const size_t n = (eList.size() == 0 ? 0 : eList.back().first + 1);
+
+    size_t loops = 0;
+    for (const intPair& edge : eList)
+    {
+        if (edge.first == edge.second) loops++;
+    }
+
+    allocate(n, eList.size() - loops, true);
+
+    size_t idx = 0;
+    for (size_t i = 0; i < eList.size(); i++)
+    {
+        int fId = eList[i].first;
+        int tId = eList[i].second;
+
+        if (fId == tId) continue;
+
+        offsets[fId + 1]++;
+        neighbours[idx] = tId;
+        weights[idx] = wList[i];
+        idx++;
+    }
+
+    for (size_t vId = 0; vId < n; vId++)
+    {
+        offsets[vId + 1] += offsets[vId];
+    }
+
+    if (!half) expand();
+}
+
+// Constructor.
+// Creates a graph without weights. Same requirements as above.
+CsrGraph::CsrGraph(const vector<intPair>& eList, bool half)
+{
+    // Same as above, but without weights.
+
+    for (size_t i = 0; i < eList.size(); i++)
+    {
+        if (eList[i].first < eList[i].second)
+        {
+            throw logic_error("From-ID < to-ID.");
+        }
+
+        if (i > 0 && eList[i - 1] >= eList[i])
+        {
+            throw logic_error("List not sorted or contains duplicates.");
+        }
+    }
+
+    const size_t n = (eList.size() == 0 ? 0 : eList.back().first + 1);
+
+    size_t loops = 0;
+    for (const intPair& edge : eList)
+    {
+        if (edge.first == edge.second) loops++;
+    }
+
+    allocate(n, eList.size() - loops, false);
+
+    size_t idx = 0;
+    for (const intPair& edge : eList)
+    {
+        if (edge.first == edge.second) continue;
+
+        offsets[edge.first + 1]++;
+        neighbours[idx++] = edge.second;
+    }
+
+    for (size_t vId = 0; vId < n; vId++)
+    {
+        offsets[vId + 1] += offsets[vId];
+    }
+
+    if (!half) expand();
+}
+
+// Move constructor.
+CsrGraph::CsrGraph(CsrGraph&& other)
+{
+    vSize = other.vSize;
+    nSize = other.nSize;
+    offsets = other.offsets;
+    neighbours = other.neighbours;
+    weights = other.weights;
+    half = other.half;
+
+    other.allocate(0, 0, false);
+}
+
+// Destructor.
+CsrGraph::~CsrGraph()
+{
+    destruct();
+}
+
+
+// Builds a graph with n vertices row by row with multiple threads.
+// Rows must not contain duplicates.
+CsrGraph CsrGraph::fromRows(size_t n, const rowSource& rows, bool weighted, bool half)
+{
+    // Each block of vertices collects its rows in its own buffer. Once all
+    // row sizes are known, the buffers are copied into the graph.
+
+    const size_t blockSize = 256;
+    const size_t blocks = (n + blockSize - 1) / blockSize;
+
+    vector<vector<int>> blockNei(blocks);
+    vector<vector<int>> blockWei(blocks);
+
+    // Row of vertex v starts at offsets[v].
+    vector<size_t> offsets(n + 1, 0);
+
+    parallelFor(n, blockSize, [&](size_t tId, size_t fr, size_t to)
+    {
+        vector<int>& nei = blockNei[fr / blockSize];
+        vector<int>& wei = blockWei[fr / blockSize];
+
+        vector<int> rowNei;
+        vector<int> rowWei;
+        vector<intPair> rowPairs;
+
+        for (size_t vId = fr; vId < to; vId++)
+        {
+            rowNei.clear();
+            rowWei.clear();
+            rows(tId, vId, rowNei, rowWei);
+
+            if (weighted)
+            {
+                assert(rowNei.size() == rowWei.size());
+
+                // Sort neighbours together with their weights.
+                rowPairs.clear();
+                for (size_t i = 0; i < rowNei.size(); i++)
+                {
+                    rowPairs.push_back(intPair(rowNei[i], rowWei[i]));
+                }
+
+                sort(rowPairs.begin(), rowPairs.end());
+
+                for (const intPair& p : rowPairs)
+                {
+                    nei.push_back(p.first);
+                    wei.push_back(p.second);
+                }
+            }
+            else
+            {
+                sort(rowNei.begin(), rowNei.end());
+                nei.insert(nei.end(), rowNei.begin(), rowNei.end());
+            }
+
+            offsets[vId + 1] = rowNei.size();
+        }
+    });
+
+    for (size_t vId = 0; vId < n; vId++)
+    {
+        offsets[vId + 1] += offsets[vId];
+    }
+
+
+    // --- Copy rows into graph. ---
+
+    CsrGraph g;
+    g.destruct();
+    g.allocate(n, offsets[n], weighted);
+
+    copy(offsets.begin(), offsets.end(), g.offsets);
+
+    parallelFor(blocks, 1, [&](size_t tId, size_t fr, size_t to)
+    {
+        for (size_t b = fr; b < to; b++)
+        {
+            size_t start = offsets[b * blockSize];
+
+            copy(blockNei[b].begin(), blockNei[b].end(), g.neighbours + start);
+            vector<int>().swap(blockNei[b]);
+
+            if (!weighted) continue;
+
+            copy(blockWei[b].begin(), blockWei[b].end(), g.weights + start);
+            vector<int>().swap(blockWei[b]);
+        }
+    });
+
+    if (!half) g.expand();
+    return g;
+}
+
+// Builds a graph with n vertices and without weights from a list of edges.
+// Calls source twice (to count and to store edges); it has to pass the
+// same edges both times. Edges must not repeat; loops are ignored.
+CsrGraph CsrGraph::fromEdges(size_t n, const edgeSource& source, bool half)
+{
+    // --- Count edges per row. ---
+
+    // counts[v + 2] counts the row of v. After the prefix sum, counts[v + 1]
+    // is the start of the row of v. That way, we can use counts[v + 1] as
+    // cursor when storing edges and end up with the correct offsets.
+    vector<size_t> counts(n + 2, 0);
+
+    source([&](int fId, int tId)
+    {
+        if (fId == tId) return;
+        if (fId < tId) swap(fId, tId);
+
+        if (tId < 0 || fId >= n) throw out_of_range("vId");
+
+        counts[fId + 2]++;
+    });
+
+    for (size_t vId = 0; vId < n; vId++)
+    {
+        counts[vId + 2] += counts[vId + 1];
+    }
+
+    CsrGraph g;
+    g.destruct();
+    g.allocate(n, counts[n + 1], false);
+
+
+    // --- Store edges. ---
+
+    source([&](int fId, int tId)
+    {
+        if (fId == tId) return;
+        if (fId < tId) swap(fId, tId);
+
+        g.neighbours[counts[fId + 1]++] = tId;
+    });
+
+    copy(counts.begin(), counts.begin() + n + 1, g.offsets);
+
+
+    // --- Sort rows. ---
+
+    parallelFor(n, 1024, [&](size_t tId, size_t fr, size_t to)
+    {
+        for (size_t vId = fr; vId < to; vId++)
+        {
+            sort(g.neighbours + g.offsets[vId], g.neighbours + g.offsets[vId + 1]);
+        }
+    });
+
+    if (!half) g.expand();
+    return g;
+}
+
+
+// Move assignment.
+CsrGraph& CsrGraph::operator=(CsrGraph&& other)
+{
+    destruct();
+
+    vSize = other.vSize;
+    nSize = other.nSize;
+    offsets = other.offsets;
+    neighbours = other.neighbours;
+    weights = other.weights;
+    half = other.half;
+
+    other.allocate(0, 0, false);
+
+    return *this;
+}
+
+
+// Returns the neighbours of the given vertex.
+IdSpan CsrGraph::operator[](const int vId) const
+{
+    if (vId < 0 || vId >= vSize) throw out_of_range("vId");
+
+    return IdSpan(neighbours + offsets[vId], neighbours + offsets[vId + 1]);
+}
+
+// Returns the weights to neighbours of the given vertex.
+IdSpan CsrGraph::operator()(const int vId) const
+{
+    if (vId < 0 || vId >= vSize) throw out_of_range("vId");
+    if (weights == nullptr) throw logic_error("Graph has no weights.");
+
+    return IdSpan(weights + offsets[vId], weights + offsets[vId + 1]);
+}
+
+
+// The number of vertices.
+size_t CsrGraph::size() const
+{
+    return vSize;
+}
+
+// The number of edges.
+size_t CsrGraph::edgeCount() const
+{
+    return half ? nSize : nSize / 2;
+}
+
+// Determines if the graph stores weights.
+bool CsrGraph::hasWeights() const
+{
+    return weights != nullptr;
+}
+
+// Determines if each edge is only stored at its larger endpoint.
+bool CsrGraph::isHalf() const
+{
+    return half;
+}
+
+
+
+// Returns all edges as list sorted by vertex-IDs with from-ID > to-ID,
+// i.e., in the order Graph needs. Uses multiple threads; each row is
+// written directly to its final position.
+vector<intPair> CsrGraph::toEdgeList() const
+{
+    // Rows are sorted. With full storage, the neighbours with a smaller ID
+    // are a prefix of each row.
+
+    vector<size_t> lowOffsets(vSize + 1, 0);
+
+    for (size_t vId = 0; vId < vSize; vId++)
+    {
+        IdSpan row = operator[](vId);
+        size_t count = half ? row.size() : lower_bound(row.begin(), row.end(), (int)vId) - row.begin();
+
+        lowOffsets[vId + 1] = lowOffsets[vId] + count;
+    }
+
+    vector<intPair> eList(lowOffsets[vSize]);
+
+    parallelFor(vSize, 1024, [&](size_t tId, size_t fr, size_t to)
+    {
+        for (size_t vId = fr; vId < to; vId++)
+        {
+            const int* nei = neighbours + offsets[vId];
+            size_t count = lowOffsets[vId + 1] - lowOffsets[vId];
+
+            for (size_t i = 0; i < count; i++)
+            {
+                eList[lowOffsets[vId] + i] = intPair(vId, nei[i]);
+            }
+        }
+    });
+
+    return eList;
+}
+
+
+// Allocates memory for the given number of vertices and neighbours.
+void CsrGraph::allocate(size_t n, size_t nCount, bool weighted)
+{
+    vSize = n;
+    nSize = nCount;
+    half = true;
+
+    offsets = new size_t[n + 1]();
+    neighbours = new int[nCount];
+    weights = weighted ? new int[nCount] : nullptr;
+}
+
+// Frees all memory.
+void CsrGraph::destruct()
+{
+    if (offsets != nullptr) delete[] offsets;
+    if (neighbours != nullptr) delete[] neighbours;
+    if (weights != nullptr) delete[] weights;
+
+    offsets = nullptr;
+    neighbours = nullptr;
+    weights = nullptr;
+}
+
+// Converts half storage into full storage.
+void CsrGraph::expand()
+{
+    // Each vertex v gets its smaller neighbours (its current row) followed by
+    // its larger neighbours. We add v to the rows of its smaller neighbours
+    // in increasing order of v. Hence, all rows stay sorted.
+
+    if (!half) return;
+
+    size_t* newOffsets = new size_t[vSize + 1]();
+
+    for (size_t vId = 0; vId < vSize; vId++)
+    {
+        newOffsets[vId + 1] += offsets[vId + 1] - offsets[vId];
+
+        for (size_t i = offsets[vId]; i < offsets[vId + 1]; i++)
+        {
+            newOffsets[neighbours[i] + 1]++;
+        }
+    }
+
+    for (size_t vId = 0; vId < vSize; vId++)
+    {
+        newOffsets[vId + 1] += newOffsets[vId];
+    }
+
+    const size_t newSize = newOffsets[vSize];
+    int* newNeighbours = new int[newSize];
+    int* newWeights = weights != nullptr ? new int[newSize] : nullptr;
+
+
+    // Copy smaller neighbours.
+    size_t* cursor = new size_t[vSize];
+
+    parallelFor(vSize, 1024, [&](size_t tId, size_t fr, size_t to)
+    {
+        for (size_t vId = fr; vId < to; vId++)
+        {
+            size_t len = offsets[vId + 1] - offsets[vId];
+
+            copy(neighbours + offsets[vId], neighbours + offsets[vId + 1], newNeighbours + newOffsets[vId]);
+            if (newWeights != nullptr)
+            {
+                copy(weights + offsets[vId], weights + offsets[vId + 1], newWeights + newOffsets[vId]);
+            }
+
+            cursor[vId] = newOffsets[vId] + len;
+        }
+    });
+
+    // Add larger neighbours.
+    for (size_t vId = 0; vId < vSize; vId++)
+    {
+        for (size_t i = offsets[vId]; i < offsets[vId + 1]; i++)
+        {
+            size_t idx = cursor[neighbours[i]]++;
+
+            newNeighbours[idx] = vId;
+            if (newWeights != nullptr) newWeights[idx] = weights[i];
+        }
+    }
+
+    delete[] cursor;
+
+
+    size_t n = vSize;
+    destruct();
+
+    vSize = n;
+    nSize = newSize;
+    offsets = newOffsets;
+    neighbours = newNeighbours;
+    weights = newWeights;
+    half = false;
+}
@@ -0,0 +1,128 @@
+// Represents an undirected graph in compressed sparse row (CSR) format.
+
+#ifndef __CsrGraph_H__
+#define __CsrGraph_H__
+
+
+#include <functional>
+#include <vector>
+
+#include "../helper.h"
+#include "idSpan.h"
+
+
+using namespace std;
+
+
+// Represents an undirected graph in compressed sparse row (CSR) format.
+class CsrGraph
+{
+    // The neighbours of all vertices are stored consecutively in a single
+    // array. The neighbours of each vertex are sorted. Weights are optional
+    // and stored in a second array parallel to the first.
+    // With full storage, each edge is stored twice (once per endpoint). With
+    // half storage, each edge is only stored at its larger endpoint, i.e., a
+    // vertex only lists neighbours with a smaller ID.
+
+public:
+
+    // Receives an edge (from-ID, to-ID).
+    typedef function<void(int, int)> edgeSink;
+
+    // Passes all edges of a graph to the given sink.
+    typedef function<void(const edgeSink&)> edgeSource;
+
+    // Computes the neighbours of a vertex with a smaller ID.
+    // Called as rows(tId, vId, nei, wei) where tId in [0, threadCount())
+    // identifies the calling thread. Appends the neighbours to nei and (if
+    // weighted) their weights to wei. The order does not matter.
+    typedef function<void(size_t, int, vector<int>&, vector<int>&)> rowSource;
+
+
+    // Default constructor.
+    // Creates an empty graph.
+    CsrGraph();
+
+    // Constructor.
+    // Needs to be sorted by vertex-IDs, not contain duplicates, and from-ID >= to-ID.
+    // Pairs with from-ID == to-ID are not added as edges (allows isolated vertices).
+    CsrGraph(const vector<intPair>& eList, const vector<int>& wList, bool half = false);
+
+    // Constructor.
+    // Creates a graph without weights. Same requirements as above.
+    CsrGraph(const vector<intPair>& eList, bool half = false);
+
+    // Move constructor.
+    CsrGraph(CsrGraph&&);
+
+    // Destructor.
+    ~CsrGraph();
+
+
+    // Builds a graph with n vertices row by row with multiple threads.
+    // Rows must not contain duplicates.
+    static CsrGraph fromRows(size_t n, const rowSource& rows, bool weighted, bool half = false);
+
+    // Builds a graph with n vertices and without weights from a list of edges.
+    // Calls source twice (to count and to store edges); it has to pass the
+    // same edges both times. Edges must not repeat; loops are ignored.
+    static CsrGraph fromEdges(size_t n, const edgeSource& source, bool half = false);
+
+
+    // Move assignment.
+    CsrGraph& operator=(CsrGraph&&);
+
+
+    // Returns the neighbours of the given vertex.
+    IdSpan operator[](const int vId) const;
+
+    // Returns the weights to neighbours of the given vertex.
+    IdSpan operator()(const int vId) const;
+
+
+    // The number of vertices.
+    size_t size() const;
+
+    // The number of edges.
+    size_t edgeCount() const;
+
+    // Determines if the graph stores weights.
+    bool hasWeights() const;
+
+    // Determines if each edge is only stored at its larger endpoint.
+    bool isHalf() const;
+
+
+    // Returns all edges as list sorted by vertex-IDs with from-ID > to-ID,
+    // i.e., in the order Graph needs. Uses multiple threads; each row is
+    // written directly to its final position.
+    vector<intPair> toEdgeList() const;
+
+
+private:
+
+    // Number of vertices.
+    size_t vSize = 0;
+
+    // Number of stored neighbours (twice the number of edges with full storage).
+    size_t nSize = 0;
+
+    // Neighbours of vertex v are in [offsets[v], offsets[v + 1]).
+    size_t* offsets = nullptr;
+    int* neighbours = nullptr;
+    int* weights = nullptr;
+
+    bool half = true;
+
+
+    // Allocates memory for the given number of vertices and neighbours.
+    void allocate(size_t n, size_t nCount, bool weighted);
+
+    // Frees all memory.
+    void destruct();
+
+    // Converts half storage into full storage.
+    void expand();
+};
+
+#endif
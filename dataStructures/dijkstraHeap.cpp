@@ -11,29 +11,86 @@ DijkstraHeap::DijkstraHeap() { /* Does nothing. */ }
 
 // Constructor.
 // Ceates a heap with a given size and directly fills it with "infinite" weight for each vertex.
-DijkstraHeap::DijkstraHeap(size_t capacity)
+DijkstraHeap::DijkstraHeap(size_t capacity) : DijkstraHeap(capacity, true)
 {
-    size = capacity;
+    // Nothing to do.
+}
+
+// Constructor.
+// Creates a heap with a given capacity. If fill is false, the heap starts empty
+// and update() inserts vertices; all vertices have "infinite" weight until then.
+DijkstraHeap::DijkstraHeap(size_t capacity, bool fill)
+{
+    initialize(capacity, fill);
+}
+
+// Destructor.
+DijkstraHeap::~DijkstraHeap()
+{
+    destruct();
+}
+
+
+const size_t DijkstraHeap::NotInserted = std::numeric_limits<size_t>::max() - 1;
+const size_t DijkstraHeap::Removed = std::numeric_limits<size_t>::max();
+
+
+// Allocates the arrays of the heap. Clears the heap if it already exists.
+// See the constructors for the meaning of fill.
+void DijkstraHeap::initialize(size_t capacity, bool fill)
+{
+    destruct();
+
+    size = fill ? capacity : 0;
 
     // Create arrays.
     verIds = new size_t[capacity];
     weights = new int[capacity];
     indices = new size_t[capacity];
+    touched = new size_t[capacity];
 
     for (size_t vId = 0; vId < capacity; vId++)
     {
         verIds[vId] = vId;
         weights[vId] = std::numeric_limits<int>::max();
-        indices[vId] = vId;
+        indices[vId] = fill ? vId : NotInserted;
+        touched[vId] = vId;
+    }
+
+    // When filled, all vertices count as touched.
+    touchedCount = fill ? capacity : 0;
+}
+
+// Empties the heap and sets the weight of each vertex back to "infinite".
+// Takes time proportional to the number of vertices that were touched since
+// the last reset, not to the capacity.
+void DijkstraHeap::reset()
+{
+    for (size_t i = 0; i < touchedCount; i++)
+    {
+        size_t vId = touched[i];
+
+        weights[vId] = std::numeric_limits<int>::max();
+        indices[vId] = NotInserted;
     }
+
+    size = 0;
+    touchedCount = 0;
 }
 
-// Destructor.
-DijkstraHeap::~DijkstraHeap()
+// Helper function for destructor and initialize().
+// Frees occupied memory.
+void DijkstraHeap::destruct()
 {
     if (verIds != nullptr) delete[] verIds;
     if (weights != nullptr) delete[] weights;
     if (indices != nullptr) delete[] indices;
+    if (touched != nullptr) delete[] touched;
+
+    verIds = nullptr;
+    weights = nullptr;
+    indices = nullptr;
+    touched = nullptr;
 }
 
 
@@ -74,7 +131,7 @@ size_t DijkstraHeap::removeMin()
     size--;
     verIds[0] = verIds[size];
 
-    indices[minId] = std::numeric_limits<size_t>::max();
+    indices[minId] = Removed;
     indices[verIds[0]] = 0;
 
     heapify(0);
@@ -83,13 +140,29 @@ size_t DijkstraHeap::removeMin()
 }
 
 
+// Updates the weight of a vertex in the heap.
+// Inserts the vertex if it was not in the heap since the last reset.
 void DijkstraHeap::update(size_t vId, int vWei)
 {
-    if (indices[vId] == std::numeric_limits<size_t>::max())
+    if (indices[vId] == Removed)
     {
         std::logic_error("Vertex is not in heap.");
     }
 
+    if (indices[vId] == NotInserted)
+    {
+        touched[touchedCount] = vId;
+        touchedCount++;
+
+        verIds[size] = vId;
+        indices[vId] = size;
+        weights[vId] = vWei;
+        size++;
+
+        moveUp(indices[vId]);
+        return;
+    }
+
     size_t index = indices[vId];
     weights[vId] = vWei;
 
@@ -20,6 +20,11 @@ public:
     // Ceates a heap with a given size and directly fills it with "infinite" weight for each vertex.
     DijkstraHeap(size_t capacity);
 
+    // Constructor.
+    // Creates a heap with a given capacity. If fill is false, the heap starts empty
+    // and update() inserts vertices; all vertices have "infinite" weight until then.
+    DijkstraHeap(size_t capacity, bool fill);
+
     // Destructor.
     ~DijkstraHeap();
 
@@ -42,9 +47,20 @@ public:
 
 
     // Updates the weight of a vertex in the heap.
+    // Inserts the vertex if it was not in the heap since the last reset.
     void update(size_t vId, int vWei);
 
 
+    // Allocates the arrays of the heap. Clears the heap if it already exists.
+    // See the constructors for the meaning of fill.
+    void initialize(size_t capacity, bool fill);
+
+    // Empties the heap and sets the weight of each vertex back to "infinite".
+    // Takes time proportional to the number of vertices that were touched since
+    // the last reset, not to the capacity.
+    void reset();
+
+
 private:
 
     // Moves an element down until it has a fitting place.
@@ -74,6 +90,22 @@ private:
 
     // Index in heap of each vertex.
     size_t* indices = nullptr;
+
+    // Vertices that were inserted since the last reset.
+    size_t* touched = nullptr;
+    size_t touchedCount = 0;
+
+
+    // Index of vertices that are not in the heap since the last reset.
+    static const size_t NotInserted;
+
+    // Index of vertices that were removed from the heap.
+    static const size_t Removed;
+
+
+    // Helper function for destructor and initialize().
+    // Frees occupied memory.
+    void destruct();
 };
 
 #endif
@@ -11,68 +11,41 @@ Graph::Graph() { /* Does nothing. */ }
 // Needs to be sorted by vertex-IDs, not contain duplicates, and from-ID > to-ID.
 Graph::Graph(const vector<intPair>& eList, const vector<int>& wList)
 {
-    // --- Verify input. ---
-
     // Equal length?
     if (eList.size() != wList.size())
     {
         throw logic_error("Size of given listst not equal.");
     }
 
-    // Sorted, no duplicates?
-    for (size_t i = 1; i < eList.size(); i++)
-    {
-        int preF = eList[i - 1].first;
-        int preT = eList[i - 1].second;
-
-        int curF = eList[i].first;
-        int curT = eList[i].second;
-
-        // We want that the previous entry is strictly smaller than the current.
-        // That is the case if and only if
-        //     preF < curF || (preF == curF && preT < curT).
-        // Subsequently, it is not the case if and only if
-        //     preF >= curF && (preF != curF || preT >= curT)
-        if (preF >= curF && (preF != curF || preT >= curT))
-        {
-            throw logic_error("List not sorted or contains duplicates.");
-        }
-    }
+    verifyList(eList);
+    build(eList, wList.data());
+}
 
-    // from-ID > to-ID?
-    for (size_t i = 0; i < eList.size(); i++)
+// Constructor.
+// Takes ownership of the given lists and frees them once the graph is built.
+// Same requirements as above. Trusted producers can skip the verification.
+Graph::Graph(vector<intPair>&& eList, vector<int>&& wList, bool verify)
+{
+    if (eList.size() != wList.size())
     {
-        // We allow from-ID == to-ID. That way, we can have isolated vertices.
-        if (eList[i].first < eList[i].second)
-        {
-            throw logic_error("From-ID < to-ID.");
-        }
+        throw logic_error("Size of given listst not equal.");
     }
 
+    if (verify) verifyList(eList);
+    build(eList, wList.data());
 
-    // --- Build graph. ---
-
-    // Due to order and from-ID > to-ID, largest ID is from-ID at the very end.
-    vSize = (eList.size() == 0 ? 0 : eList.back().first + 1);
-
-    edges = new vector<int>[vSize];
-    weights = new vector<int>[vSize];
-
-
-    for (size_t i = 0; i < eList.size(); i++)
-    {
-        int fId = eList[i].first;
-        int tId = eList[i].second;
-        int wei = wList[i];
-
-        if (fId == tId) continue;
+    vector<intPair>().swap(eList);
+    vector<int>().swap(wList);
+}
 
-        edges[fId].push_back(tId);
-        edges[tId].push_back(fId);
+// Constructor.
+// Creates a graph where all edges have weight 0. Same as above otherwise.
+Graph::Graph(vector<intPair>&& eList, bool verify)
+{
+    if (verify) verifyList(eList);
+    build(eList, nullptr);
 
-        weights[fId].push_back(wei);
-        weights[tId].push_back(wei);
-    }
+    vector<intPair>().swap(eList);
 }
 
 
@@ -106,3 +79,84 @@ size_t Graph::size() const
 {
     return vSize;
 }
+
+
+// Verifies that the given list is sorted, has no duplicates, and from-ID >= to-ID.
+// Throws a logic_error if not.
+void Graph::verifyList(const vector<intPair>& eList)
+{
+    for (size_t i = 0; i < eList.size(); i++)
+    {
+        // from-ID > to-ID?
+        // We allow from-ID == to-ID. That way, we can have isolated vertices.
+        if (eList[i].first < eList[i].second)
+        {
+            throw logic_error("From-ID < to-ID.");
+        }
+
+        // Sorted, no duplicates?
+        // We want that the previous entry is strictly smaller than the current.
+        if (i > 0 && eList[i - 1] >= eList[i])
+        {
+            throw logic_error("List not sorted or contains duplicates.");
+        }
+    }
+}
+
+// Builds the adjacency list from a verified edge list.
+// All weights are 0 if wList is a null pointer.
+void Graph::build(const vector<intPair>& eList, const int* wList)
+{
+    // Due to order and from-ID > to-ID, largest ID is from-ID at the very end.
+    vSize = (eList.size() == 0 ? 0 : eList.back().first + 1);
+
+    edges = new vector<int>[vSize];
+    weights = new vector<int>[vSize];
+
+
+    // --- Count degrees. ---
+
+    // Knowing the degrees allows to allocate each list exactly once.
+    vector<size_t> degree(vSize, 0);
+
+    for (const intPair& edge : eList)
+    {
+        if (edge.first == edge.second) continue;
+
+        degree[edge.first]++;
+        degree[edge.second]++;
+    }
+
+    for (size_t vId = 0; vId < vSize; vId++)
+    {
+        edges[vId].reserve(degree[vId]);
+
+        if (wList == nullptr)
+        {
+            weights[vId].assign(degree[vId], 0);
+        }
+        else
+        {
+            weights[vId].reserve(degree[vId]);
+        }
+    }
+
+
+    // --- Add edges. ---
+
+    for (size_t i = 0; i < eList.size(); i++)
+    {
+        int fId = eList[i].first;
+        int tId = eList[i].second;
+
+        if (fId == tId) continue;
+
+        edges[fId].push_back(tId);
+        edges[tId].push_back(fId);
+
+        if (wList == nullptr) continue;
+
+        weights[fId].push_back(wList[i]);
+        weights[tId].push_back(wList[i]);
+    }
+}
@@ -29,6 +29,15 @@ public:
     // Needs to be sorted by vertex-IDs, not contain duplicates, and from-ID > to-ID.
     Graph(const vector<intPair>& eList, const vector<int>& wList);
 
+    // Constructor.
+    // Takes ownership of the given lists and frees them once the graph is built.
+    // Same requirements as above. Trusted producers can skip the verification.
+    Graph(vector<intPair>&& eList, vector<int>&& wList, bool verify = true);
+
+    // Constructor.
+    // Creates a graph where all edges have weight 0. Same as above otherwise.
+    Graph(vector<intPair>&& eList, bool verify = true);
+
     // Destructor.
     ~Graph();
 
@@ -52,6 +61,15 @@ private:
 
     // Number of vertices.
     size_t vSize = 0;
+
+
+    // Verifies that the given list is sorted, has no duplicates, and from-ID >= to-ID.
+    // Throws a logic_error if not.
+    static void verifyList(const vector<intPair>& eList);
+
+    // Builds the adjacency list from a verified edge list.
+    // All weights are 0 if wList is a null pointer.
+    void build(const vector<intPair>& eList, const int* wList);
 };
 
 #endif
@@ -1,52 +1,261 @@
+#include <algorithm>
 #include <cassert>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "../algorithms/sorting.h"
 #include "hypergraph.h"
 
 
-// Default constructor.
-// Creates an empty hypergraph.
-Hypergraph::Hypergraph() : Hypergraph(0, 0)
+// Anonymous namespace for the binary file format.
+namespace
 {
-    // Nothing to do.
-}
+    // A binary file stores the CSR arrays as they are in memory:
+    //
+    //   header
+    //   eOffsets[m + 1]     (64-bit)
+    //   eIncidences[N]      (32-bit)
+    //   vOffsets[n + 1]     (64-bit, optional)
+    //   vIncidences[N]      (32-bit, optional)
+    //
+    // Each array starts at a multiple of 8 bytes; the header states where.
+    // Values use the byte order of the machine that wrote the file.
+
+    static_assert(sizeof(size_t) == sizeof(uint64_t), "Binary format requires 64-bit offsets.");
+    static_assert(sizeof(int) == sizeof(int32_t), "Binary format requires 32-bit IDs.");
+
+    // Header of a binary hypergraph file.
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t flags;
 
-// Constructor.
-// Creates a hypergraph based on an edge list.
-// Edges go from a hyperede to a vertex.
-Hypergraph::Hypergraph(const vector<intPair>& eList)
-{
-    // Ensure input is sorted.
-    vector<intPair>* ptr = Sorting::ensureSorting(eList);
-    const vector<intPair>& list = (ptr == nullptr ? eList : *ptr);
+        // Number of vertices, hyperedges, and total size.
+        uint64_t n;
+        uint64_t m;
+        uint64_t N;
+
+        // Positions (in bytes from the start of the file) of the arrays.
+        uint64_t eOffsetsPos;
+        uint64_t eIncidencesPos;
+        uint64_t vOffsetsPos;
+        uint64_t vIncidencesPos;
+    };
 
-    vector<vector<int>> eSet;
-    vector<vector<int>> vSet;
+    const char FileMagic[8] = { 'H', 'Y', 'P', 'G', 'R', 'A', 'P', 'H' };
+    const uint32_t FileVersion = 1;
 
-    eSet.resize(list.back().first + 1);
+    // Flag: the file contains the sets of vertices.
+    const uint32_t HasVertexSets = 1;
 
-    for (int i = 0; i < list.size(); i++)
+
+    // Rounds the given position up to the next multiple of 8.
+    uint64_t align8(uint64_t pos)
     {
-        int eId = list[i].first;
-        int vId = list[i].second;
+        return (pos + 7) & ~(uint64_t)7;
+    }
 
-        if (vSet.size() <= vId) vSet.resize(vId + 1);
+    // Determines if an array with the given number of elements fits into the file.
+    bool fitsInFile(uint64_t pos, uint64_t count, size_t elemSize, size_t fileSize)
+    {
+        return pos % 8 == 0 && pos <= fileSize && count <= (fileSize - pos) / elemSize;
+    }
+
+    // Maps the given file into memory (read-only) and returns its size in size.
+    // Returns nullptr for empty files. Throws an exception if that fails.
+    const char* mapFile(const string& path, size_t& size)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw runtime_error("Cannot open file " + path + ".");
+
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            close(fd);
+            throw runtime_error("Cannot open file " + path + ".");
+        }
 
-        eSet[eId].push_back(vId);
-        vSet[vId].push_back(eId);
+        size = st.st_size;
+        if (size == 0)
+        {
+            close(fd);
+            return nullptr;
+        }
+
+        void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        // The mapping stays valid after closing the file.
+        close(fd);
+
+        if (map == MAP_FAILED) throw runtime_error("Cannot map file " + path + ".");
+        return (const char*)map;
     }
 
-    initialize(vSet.size(), eSet.size(), list.size());
+    // Parses the hyperedge-vertex pairs in a part [begin, end) of a text file.
+    // The part has to start at the beginning of a line and end after a line.
+    // Returns the position of an error or nullptr if there is none.
+    // We parse by hand. Streams are too slow for large files.
+    const char* parseText(const char* begin, const char* end, Hypergraph::TextFormat format, vector<intPair>& list)
+    {
+        const char* p = begin;
+
+        // Skips spaces (but not line breaks).
+        auto skipSpaces = [&p, end]()
+        {
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+        };
+
+        // Parses a non-negative integer. Returns -1 if there is none.
+        auto parseInt = [&p, end]() -> int
+        {
+            if (p >= end || *p < '0' || *p > '9') return -1;
+
+            int64_t val = 0;
+
+            for (; p < end && *p >= '0' && *p <= '9'; p++)
+            {
+                val = val * 10 + (*p - '0');
+                if (val > INT_MAX) return -1;
+            }
+
+            return (int)val;
+        };
+
+        while (p < end)
+        {
+            skipSpaces();
+            if (p >= end) break;
+
+            // Empty line or comment.
+            if (*p == '\n' || *p == '#')
+            {
+                while (p < end && *p != '\n') p++;
+                p++;
+                continue;
+            }
+
+            int eId = parseInt();
+            if (eId < 0) return p;
+            skipSpaces();
+
+            if (format == Hypergraph::TextFormat::Sets)
+            {
+                // "eId: v1 v2 ..."
+                if (p >= end || *p != ':') return p;
+                p++;
+
+                while (true)
+                {
+                    skipSpaces();
+                    if (p >= end || *p == '\n') break;
+
+                    int vId = parseInt();
+                    if (vId < 0) return p;
 
-    for (int j = 0; j < eSize; j++)
+                    list.push_back(intPair(eId, vId));
+                }
+            }
+            else
+            {
+                // "eId vId"
+                int vId = parseInt();
+                if (vId < 0) return p;
+
+                list.push_back(intPair(eId, vId));
+
+                skipSpaces();
+                if (p < end && *p != '\n') return p;
+            }
+
+            // Skip line break.
+            p++;
+        }
+
+        return nullptr;
+    }
+
+    // Determines if the given offsets are valid, i.e., start with 0, are
+    // non-decreasing, and end with the total size N.
+    bool validOffsets(const size_t* offsets, uint64_t count, uint64_t N)
+    {
+        if (offsets[0] != 0 || offsets[count - 1] != N) return false;
+
+        for (uint64_t i = 1; i < count; i++)
+        {
+            if (offsets[i] < offsets[i - 1]) return false;
+        }
+
+        return true;
+    }
+
+    // Determines if the given sets (with valid offsets) are valid, i.e., each
+    // set is strictly increasing and all IDs are in [0, limit).
+    bool validSets(const size_t* offsets, const int* incidences, uint64_t count, uint64_t limit)
     {
-        hyperedges[j] = std::move(eSet[j]);
+        for (uint64_t i = 0; i < count; i++)
+        {
+            for (size_t j = offsets[i]; j < offsets[i + 1]; j++)
+            {
+                if (incidences[j] < 0 || (uint64_t)incidences[j] >= limit) return false;
+                if (j > offsets[i] && incidences[j] <= incidences[j - 1]) return false;
+            }
+        }
+
+        return true;
     }
 
-    for (int i = 0; i < vSize; i++)
+    // Determines if the given sets of vertices are exactly the transpose of
+    // the given sets of hyperedges. Both have to be valid (see validSets()).
+    bool validTranspose(const size_t* eOffsets, const int* eIncidences, uint64_t m,
+                        const size_t* vOffsets, const int* vIncidences, uint64_t n)
     {
-        vertices[i] = std::move(vSet[i]);
+        // Vertices are visited in increasing order. Since each hyperedge is
+        // sorted, the next vertex of each hyperedge has to be the current one.
+        vector<size_t> eNext(eOffsets, eOffsets + m);
+
+        for (uint64_t vId = 0; vId < n; vId++)
+        {
+            for (size_t i = vOffsets[vId]; i < vOffsets[vId + 1]; i++)
+            {
+                int eId = vIncidences[i];
+
+                if (eNext[eId] >= eOffsets[eId + 1] || (uint64_t)eIncidences[eNext[eId]] != vId) return false;
+                eNext[eId]++;
+            }
+        }
+
+        // Both have N incidences. Hence, all hyperedges are complete.
+        return true;
     }
+}
+
+
+// Default constructor.
+// Creates an empty hypergraph.
+Hypergraph::Hypergraph() : Hypergraph(0, 0)
+{
+    // Nothing to do.
+}
+
+// Constructor.
+// Creates a hypergraph based on an edge list.
+// Edges go from a hyperede to a vertex.
+Hypergraph::Hypergraph(const vector<intPair>& eList)
+{
+    // Ensure input is sorted.
+    vector<intPair>* ptr = Sorting::ensureSorting(eList);
+    const vector<intPair>& list = (ptr == nullptr ? eList : *ptr);
+
+    build(list.data(), list.size());
 
     if (ptr != nullptr) delete ptr;
 }
@@ -66,8 +275,15 @@ Hypergraph::Hypergraph(Hypergraph&& other)
     eSize = other.eSize;
     tSize = other.tSize;
 
-    vertices = other.vertices;
-    hyperedges = other.hyperedges;
+    vOffsets = other.vOffsets;
+    vIncidences = other.vIncidences;
+    eOffsets = other.eOffsets;
+    eIncidences = other.eIncidences;
+
+    mapping = other.mapping;
+    mapSize = other.mapSize;
+    other.mapping = nullptr;
+    other.mapSize = 0;
 
     other.initialize(0, 0, 0);
 }
@@ -83,23 +299,140 @@ Hypergraph::~Hypergraph()
 // Initialises a new hypergraph with n vertices and m hyperedges,
 // and sets the total size to N.
 // Does not create any edges in the bipartite representation.
-void Hypergraph::initialize(const int n, const int m, const int N)
+void Hypergraph::initialize(const int n, const int m, const size_t N)
 {
     vSize = n;
     eSize = m;
     tSize = N;
 
-    vertices = new vector<int>[vSize];
-    hyperedges = new vector<int>[eSize];
+    // Offsets are initialised with 0, i.e., all sets are empty.
+    vOffsets = new size_t[vSize + 1]();
+    eOffsets = new size_t[eSize + 1]();
+
+    vIncidences = new int[tSize];
+    eIncidences = new int[tSize];
+}
+
+// Helper function for constructors.
+// Creates the CSR representation from a sorted list of N hyperedge-vertex pairs.
+void Hypergraph::build(const intPair* list, const size_t N)
+{
+    // --- Determine size. ---
+
+    // Since the list is sorted, the last entry has the largest hyperedge-ID.
+    int m = (N == 0 ? 0 : list[N - 1].first + 1);
+    int n = 0;
+
+    for (size_t i = 0; i < N; i++)
+    {
+        n = max(n, list[i].second + 1);
+    }
+
+    initialize(n, m, N);
+
+
+    // --- Count size of each set. ---
+
+    // We count into the next entry. That way, the prefix sums below directly
+    // give the start index of each set.
+    for (size_t i = 0; i < N; i++)
+    {
+        eOffsets[list[i].first + 1]++;
+        vOffsets[list[i].second + 1]++;
+    }
+
+    for (int eId = 0; eId < m; eId++)
+    {
+        eOffsets[eId + 1] += eOffsets[eId];
+    }
+
+    for (int vId = 0; vId < n; vId++)
+    {
+        vOffsets[vId + 1] += vOffsets[vId];
+    }
+
+
+    // --- Fill sets. ---
+
+    // Pairs are sorted by hyperedge. Hence, the vertices of each hyperedge are
+    // already in the right order.
+    for (size_t i = 0; i < N; i++)
+    {
+        eIncidences[i] = list[i].second;
+    }
+
+    // Hyperedges are processed in increasing order. Hence, each vertex-set is
+    // sorted as well.
+    vector<size_t> vNext(vOffsets, vOffsets + n);
+
+    for (size_t i = 0; i < N; i++)
+    {
+        int eId = list[i].first;
+        int vId = list[i].second;
+
+        vIncidences[vNext[vId]] = eId;
+        vNext[vId]++;
+    }
+}
+
+// Helper function for constructors.
+// Creates the sets of vertices from the sets of hyperedges.
+// Assumes that vOffsets[] is allocated and 0 and vIncidences[] is allocated.
+void Hypergraph::buildVertexSets()
+{
+    // Same approach as in build(): count, prefix sums, then fill.
+
+    for (size_t i = 0; i < tSize; i++)
+    {
+        vOffsets[eIncidences[i] + 1]++;
+    }
+
+    for (int vId = 0; vId < vSize; vId++)
+    {
+        vOffsets[vId + 1] += vOffsets[vId];
+    }
+
+    // Hyperedges are processed in increasing order. Hence, each vertex-set is sorted.
+    vector<size_t> vNext(vOffsets, vOffsets + vSize);
+
+    for (int eId = 0; eId < eSize; eId++)
+    {
+        for (size_t i = eOffsets[eId]; i < eOffsets[eId + 1]; i++)
+        {
+            int vId = eIncidences[i];
+
+            vIncidences[vNext[vId]] = eId;
+            vNext[vId]++;
+        }
+    }
+}
+
+// Determines if the given array is in the memory-mapped file.
+bool Hypergraph::isMapped(const void* ptr) const
+{
+    if (mapping == nullptr) return false;
+
+    const char* p = (const char*)ptr;
+    const char* begin = (const char*)mapping;
+
+    // Empty arrays may start at the end of the file.
+    return p >= begin && p <= begin + mapSize;
 }
 
 // Helper function for destructor and similar operations.
 // Frees occupied memory.
 void Hypergraph::destruct()
 {
-    delete[] vertices;
-    delete[] hyperedges;
+    if (!isMapped(vOffsets)) delete[] vOffsets;
+    if (!isMapped(vIncidences)) delete[] vIncidences;
+    if (!isMapped(eOffsets)) delete[] eOffsets;
+    if (!isMapped(eIncidences)) delete[] eIncidences;
     if (dual != nullptr && !isDual) delete dual;
+    dual = nullptr;
+
+    if (mapping != nullptr) munmap(mapping, mapSize);
+    mapping = nullptr;
+    mapSize = 0;
 }
 
 
@@ -116,7 +449,7 @@ int Hypergraph::getESize() const
 }
 
 // The combined size of all hyperedges.
-int Hypergraph::getTotalSize() const
+size_t Hypergraph::getTotalSize() const
 {
     return tSize;
 }
@@ -131,8 +464,15 @@ Hypergraph& Hypergraph::operator=(Hypergraph&& other)
     eSize = other.eSize;
     tSize = other.tSize;
 
-    vertices = other.vertices;
-    hyperedges = other.hyperedges;
+    vOffsets = other.vOffsets;
+    vIncidences = other.vIncidences;
+    eOffsets = other.eOffsets;
+    eIncidences = other.eIncidences;
+
+    mapping = other.mapping;
+    mapSize = other.mapSize;
+    other.mapping = nullptr;
+    other.mapSize = 0;
 
     other.initialize(0, 0, 0);
 
@@ -141,17 +481,17 @@ Hypergraph& Hypergraph::operator=(Hypergraph&& other)
 
 
 // Returns the hyperedge with index i.
-const vector<int>& Hypergraph::operator[](const int i) const
+IdSpan Hypergraph::operator[](const int i) const
 {
     assert(i >= 0 && i < eSize);
-    return hyperedges[i];
+    return IdSpan(eIncidences + eOffsets[i], eIncidences + eOffsets[i + 1]);
 }
 
 // Returns the hyperedges containing the vertex with index j.
-const vector<int>& Hypergraph::operator()(const int j) const
+IdSpan Hypergraph::operator()(const int j) const
 {
     assert(j >= 0 && j < vSize);
-    return vertices[j];
+    return IdSpan(vIncidences + vOffsets[j], vIncidences + vOffsets[j + 1]);
 }
 
 
@@ -162,7 +502,7 @@ void Hypergraph::print(ostream& out) const
     {
         out << eId << ":";
 
-        const vector<int>& vList = hyperedges[eId];
+        IdSpan vList = operator[](eId);
         for (int i = 0; i < vList.size(); i++)
         {
             out << " " << vList[i];
@@ -173,83 +513,464 @@ void Hypergraph::print(ostream& out) const
 }
 
 
+// Anonymous namespace for the linegraph engines.
+namespace
+{
+    // Number of hyperedges per block processed by a thread.
+    const size_t LgBlockSize = 64;
+
+    // Heavy vertices are in at least m / HeavyDivisor hyperedges.
+    const size_t HeavyDivisor = 8;
+
+    // Maximum number of heavy vertices (and bits per hyperedge).
+    const size_t MaxHeavy = 64;
+
+
+    // Concatenates the edges (and weights) computed for each block.
+    // Blocks are assumed to cover consecutive ranges of from-IDs.
+    Graph combineBlocks(vector<vector<intPair>>& blockPairs, vector<vector<int>>& blockWeigs)
+    {
+        const size_t blocks = blockPairs.size();
+
+        vector<size_t> offsets(blocks + 1, 0);
+        for (size_t b = 0; b < blocks; b++)
+        {
+            offsets[b + 1] = offsets[b] + blockPairs[b].size();
+        }
+
+        vector<intPair> pairList(offsets[blocks]);
+        vector<int> weigList(offsets[blocks]);
+
+        parallelFor(blocks, 1, [&](size_t tId, size_t fr, size_t to)
+        {
+            for (size_t b = fr; b < to; b++)
+            {
+                copy(blockPairs[b].begin(), blockPairs[b].end(), pairList.begin() + offsets[b]);
+                copy(blockWeigs[b].begin(), blockWeigs[b].end(), weigList.begin() + offsets[b]);
+
+                vector<intPair>().swap(blockPairs[b]);
+                vector<int>().swap(blockWeigs[b]);
+            }
+        });
+
+        // The lists are sorted and free of duplicates by construction.
+        return Graph(move(pairList), move(weigList), false);
+    }
+
+
+    // A hash table that counts how often each key is added.
+    // Uses open addressing with linear probing. Keys are non-negative.
+    // Lookups assume the key is in the table.
+    class CountTable
+    {
+    public:
+
+        // Prepares the table for at most the given number of distinct keys.
+        // Assumes the table is empty.
+        void reserve(size_t count)
+        {
+            size_t cap = 16;
+            while (cap < 2 * count) cap *= 2;
+
+            if (cap > keys.size())
+            {
+                keys.assign(cap, -1);
+                counts.assign(cap, 0);
+            }
+
+            // Only use what is needed to stay in cache.
+            mask = cap - 1;
+        }
+
+        // Increments the count of the given key.
+        void add(int key)
+        {
+            size_t idx = ((uint32_t)key * 0x9E3779B1u) & mask;
+
+            while (keys[idx] != key)
+            {
+                if (keys[idx] < 0)
+                {
+                    keys[idx] = key;
+                    used.push_back(key);
+                    break;
+                }
+
+                idx = (idx + 1) & mask;
+            }
+
+            counts[idx]++;
+        }
+
+        // Returns the count of the given key and removes it.
+        int take(int key)
+        {
+            size_t idx = ((uint32_t)key * 0x9E3779B1u) & mask;
+            while (keys[idx] != key) idx = (idx + 1) & mask;
+
+            int count = counts[idx];
+            counts[idx] = 0;
+
+            // Keys stay until clear() to keep probe sequences intact.
+            return count;
+        }
+
+        // The keys added since the last clear(), in order of insertion.
+        vector<int>& keyList()
+        {
+            return used;
+        }
+
+        // Removes all keys.
+        void clear()
+        {
+            for (const int& key : used)
+            {
+                size_t idx = ((uint32_t)key * 0x9E3779B1u) & mask;
+                while (keys[idx] != key) idx = (idx + 1) & mask;
+
+                // Lookups do not stop at free slots. Hence, the order does not matter.
+                keys[idx] = -1;
+                counts[idx] = 0;
+            }
+
+            used.clear();
+        }
+
+    private:
+
+        vector<int> keys;
+        vector<int> counts;
+        vector<int> used;
+        size_t mask = 0;
+    };
+}
+
+
 // Computes the weighted linegraph of the hypergraph.
-Graph Hypergraph::getLinegraph() const
+// Uses multiple threads.
+Graph Hypergraph::getLinegraph(LinegraphEngine engine) const
+{
+    if (engine == LinegraphEngine::Scan) return linegraphScan();
+
+    vector<int> heavy = heavyVertices();
+    if (engine == LinegraphEngine::Degree) return linegraphDegree(heavy);
+
+
+    // --- Auto ---
+
+    // Both engines spend most time on pairs of hyperedges sharing a vertex,
+    // i.e., on the sum of d(v)^2. The Degree engine only pays off if heavy
+    // vertices cause most of it.
+
+    double total = 0.0;
+    double heavyWork = 0.0;
+
+    for (int vId = 0; vId < getVSize(); vId++)
+    {
+        double deg = vOffsets[vId + 1] - vOffsets[vId];
+        total += deg * deg;
+    }
+
+    for (const int& vId : heavy)
+    {
+        double deg = vOffsets[vId + 1] - vOffsets[vId];
+        heavyWork += deg * deg;
+    }
+
+    if (heavy.size() > 0 && 2.0 * heavyWork >= total)
+    {
+        return linegraphDegree(heavy);
+    }
+
+    return linegraphScan();
+}
+
+// Returns the heavy vertices, i.e., the (at most 64) vertices with the
+// largest degree that are in at least m / 8 hyperedges.
+// They are ordered by non-increasing degree.
+vector<int> Hypergraph::heavyVertices() const
+{
+    const size_t minDeg = max((size_t)getESize() / HeavyDivisor, (size_t)2);
+
+    vector<int> heavy;
+    for (int vId = 0; vId < getVSize(); vId++)
+    {
+        if (vOffsets[vId + 1] - vOffsets[vId] >= minDeg) heavy.push_back(vId);
+    }
+
+    auto byDegree = [this](const int& lhs, const int& rhs)
+    {
+        size_t lDeg = vOffsets[lhs + 1] - vOffsets[lhs];
+        size_t rDeg = vOffsets[rhs + 1] - vOffsets[rhs];
+        return lDeg > rDeg || (lDeg == rDeg && lhs < rhs);
+    };
+
+    if (heavy.size() > MaxHeavy)
+    {
+        nth_element(heavy.begin(), heavy.begin() + MaxHeavy, heavy.end(), byDegree);
+        heavy.resize(MaxHeavy);
+    }
+
+    sort(heavy.begin(), heavy.end(), byDegree);
+    return heavy;
+}
+
+// Computes the linegraph with the Scan engine.
+Graph Hypergraph::linegraphScan() const
 {
     // We compute the linegraph by running a BFS-ish search on each hyperedge in
-    // the incidence graph. The search is limited to two hops. Each hyperedge
-    // the search reaches is counted in a table. That count becomes the weight
-    // of the corresponding linegraph edge.
+    // the incidence graph. The search is limited to two hops and only follows
+    // hyperedges with a smaller ID. Each hyperedge the search reaches is
+    // counted in a table. That count becomes the weight of the corresponding
+    // linegraph edge.
+    // Hyperedges are processed in blocks. Each thread has its own table and
+    // each block collects its edges in its own buffer. Since a block only
+    // produces edges whose from-ID is in the block, concatenating the buffers
+    // gives a sorted list.
 
     const size_t m = getESize();
+    const size_t blocks = (m + LgBlockSize - 1) / LgBlockSize;
 
-    vector<vector<intPair>> edgeList(m);
-
-    size_t totalSize = 0;
+    vector<vector<intPair>> blockPairs(blocks);
+    vector<vector<int>> blockWeigs(blocks);
 
-    vector<size_t> map;
-    map.resize(m, 0);
+    // Tables are allocated by the threads that use them.
+    vector<vector<size_t>> maps(threadCount());
 
-    vector<int> inMap;
 
+    // --- Compute edges. ---
 
-    for (int toId = 0; toId < m; toId++)
+    parallelFor(m, LgBlockSize, [&](size_t tId, size_t fr, size_t to)
     {
-        const vector<int>& vList = operator[](toId);
+        vector<size_t>& map = maps[tId];
+        if (map.empty()) map.resize(m, 0);
 
-        for (const int& vId : vList)
+        vector<intPair>& pairs = blockPairs[fr / LgBlockSize];
+        vector<int>& weigs = blockWeigs[fr / LgBlockSize];
+
+        vector<int> inMap;
+
+        for (int frId = fr; frId < to; frId++)
         {
-            const vector<int>& eList = operator()(vId);
+            IdSpan vList = operator[](frId);
 
-            for (size_t i = eList.size() - 1; i < eList.size(); i--)
+            for (const int& vId : vList)
             {
-                int frId = eList[i];
-                if (frId <= toId) break;
+                IdSpan eList = operator()(vId);
 
-                if (map[frId] == 0)
+                for (size_t i = 0; i < eList.size(); i++)
                 {
-                    inMap.push_back(frId);
+                    int toId = eList[i];
+                    if (toId >= frId) break;
+
+                    if (map[toId] == 0)
+                    {
+                        inMap.push_back(toId);
+                    }
+
+                    map[toId]++;
                 }
+            }
+
+            sort(inMap.begin(), inMap.end());
 
-                map[frId]++;
+            for (int& toId : inMap)
+            {
+                pairs.push_back(intPair(frId, toId));
+                weigs.push_back(map[toId]);
+
+                map[toId] = 0;
             }
+
+            inMap.clear();
         }
+    });
+
+    return combineBlocks(blockPairs, blockWeigs);
+}
+
+// Computes the linegraph with the Degree engine.
+// Uses the given list of heavy vertices.
+Graph Hypergraph::linegraphDegree(const vector<int>& heavy) const
+{
+    // Vertices are split by degree.
+    //   Heavy: Each hyperedge stores the heavy vertices it contains as bitset
+    //          (bit i represents heavy[i], i.e., bits are ordered by degree).
+    //          A hyperedge X intersects all hyperedges with a smaller ID
+    //          that contain a heavy vertex by scanning their bitsets in order.
+    //          The number of shared heavy vertices is the popcount of the AND.
+    //   Light: Counted as in the Scan engine, but in a hash table sized for
+    //          the hyperedge at hand. It stays in cache, while a table of size
+    //          m does not.
+    // Both results are sorted by ID and merged.
+    //
+    // Blocks are processed in order of non-increasing cost (estimated by the
+    // degrees of their vertices) to balance the load between threads.
 
-        for (int& frId : inMap)
+    const size_t m = getESize();
+    const size_t blocks = (m + LgBlockSize - 1) / LgBlockSize;
+    const size_t words = (heavy.size() + 63) / 64;
+
+
+    // --- Bitsets of heavy vertices. ---
+
+    vector<int> heavyIdx(getVSize(), -1);
+    for (size_t i = 0; i < heavy.size(); i++)
+    {
+        heavyIdx[heavy[i]] = i;
+    }
+
+    // Hyperedges containing a heavy vertex, in order of their ID, and their bitsets.
+    // heavyPos[X] is the index of X in heavyEdges or -1.
+    vector<int> heavyEdges;
+    vector<int> heavyPos(m, -1);
+    vector<uint64_t> bitsets;
+
+    for (int eId = 0; eId < m; eId++)
+    {
+        for (const int& vId : operator[](eId))
         {
-            int weig = map[frId];
-            map[frId] = 0;
+            int hIdx = heavyIdx[vId];
+            if (hIdx < 0) continue;
+
+            if (heavyPos[eId] < 0)
+            {
+                heavyPos[eId] = heavyEdges.size();
+                heavyEdges.push_back(eId);
+                bitsets.resize(bitsets.size() + words, 0);
+            }
+
+            bitsets[heavyPos[eId] * words + hIdx / 64] |= (uint64_t)1 << (hIdx % 64);
+        }
+    }
+
+
+    // --- Order blocks by cost. ---
 
-            edgeList[frId].push_back(intPair(toId, weig));
+    vector<size_t> blockCost(blocks, 0);
+    for (size_t eId = 0; eId < m; eId++)
+    {
+        for (const int& vId : operator[](eId))
+        {
+            blockCost[eId / LgBlockSize] += heavyIdx[vId] < 0 ? vOffsets[vId + 1] - vOffsets[vId] : 0;
         }
 
-        totalSize += inMap.size();
-        inMap.clear();
+        if (heavyPos[eId] >= 0) blockCost[eId / LgBlockSize] += heavyPos[eId] * words;
     }
 
-    vector<intPair> pairList;
-    vector<int> weigList;
+    vector<size_t> blockOrder(blocks);
+    for (size_t b = 0; b < blocks; b++) blockOrder[b] = b;
 
-    pairList.resize(totalSize);
-    weigList.resize(totalSize);
+    sort(blockOrder.begin(), blockOrder.end(), [&blockCost](const size_t& lhs, const size_t& rhs)
+    {
+        return blockCost[lhs] > blockCost[rhs];
+    });
 
-    size_t ptr = 0;
 
-    for (int frId = 0; frId < m; frId++)
+    // --- Compute edges. ---
+
+    vector<vector<intPair>> blockPairs(blocks);
+    vector<vector<int>> blockWeigs(blocks);
+
+    vector<CountTable> tables(threadCount());
+
+    parallelFor(blocks, 1, [&](size_t tId, size_t frB, size_t toB)
     {
-        for (size_t i = 0; i < edgeList[frId].size(); i++)
+        CountTable& table = tables[tId];
+
+        for (size_t i = frB; i < toB; i++)
         {
-            int toId = edgeList[frId][i].first;
-            int weig = edgeList[frId][i].second;
+            const size_t b = blockOrder[i];
+            const int fr = b * LgBlockSize;
+            const int to = min(fr + LgBlockSize, m);
+
+            vector<intPair>& pairs = blockPairs[b];
+            vector<int>& weigs = blockWeigs[b];
+
+            for (int frId = fr; frId < to; frId++)
+            {
+                IdSpan vList = operator[](frId);
+
+
+                // --- Light vertices. ---
+
+                size_t bound = 0;
+                for (const int& vId : vList)
+                {
+                    if (heavyIdx[vId] < 0) bound += vOffsets[vId + 1] - vOffsets[vId];
+                }
+
+                table.reserve(bound);
+
+                for (const int& vId : vList)
+                {
+                    if (heavyIdx[vId] >= 0) continue;
+
+                    IdSpan eList = operator()(vId);
+
+                    for (size_t j = 0; j < eList.size(); j++)
+                    {
+                        int toId = eList[j];
+                        if (toId >= frId) break;
+
+                        table.add(toId);
+                    }
+                }
 
-            pairList[ptr] = intPair(frId, toId);
-            weigList[ptr] = weig;
+                vector<int>& lightIds = table.keyList();
+                sort(lightIds.begin(), lightIds.end());
 
-            ptr++;
+
+                // --- Heavy vertices and merge. ---
+
+                const int pos = heavyPos[frId];
+                const uint64_t* frBits = pos < 0 ? nullptr : bitsets.data() + pos * words;
+
+                size_t lIdx = 0;
+                for (int k = 0; k < max(pos, 0); k++)
+                {
+                    const uint64_t* toBits = bitsets.data() + k * words;
+
+                    int weight = 0;
+                    for (size_t w = 0; w < words; w++)
+                    {
+                        weight += __builtin_popcountll(frBits[w] & toBits[w]);
+                    }
+
+                    if (weight == 0) continue;
+
+                    int toId = heavyEdges[k];
+
+                    // Light neighbours with a smaller ID.
+                    for (; lIdx < lightIds.size() && lightIds[lIdx] < toId; lIdx++)
+                    {
+                        pairs.push_back(intPair(frId, lightIds[lIdx]));
+                        weigs.push_back(table.take(lightIds[lIdx]));
+                    }
+
+                    if (lIdx < lightIds.size() && lightIds[lIdx] == toId)
+                    {
+                        weight += table.take(toId);
+                        lIdx++;
+                    }
+
+                    pairs.push_back(intPair(frId, toId));
+                    weigs.push_back(weight);
+                }
+
+                for (; lIdx < lightIds.size(); lIdx++)
+                {
+                    pairs.push_back(intPair(frId, lightIds[lIdx]));
+                    weigs.push_back(table.take(lightIds[lIdx]));
+                }
+
+                table.clear();
+            }
         }
-    }
+    });
 
-    return Graph(pairList, weigList);
+    return combineBlocks(blockPairs, blockWeigs);
 }
 
 // Return the dual hypergraph.
@@ -270,8 +991,262 @@ Hypergraph::Hypergraph(const Hypergraph* hg)
     vSize = hg->eSize;
     eSize = hg->vSize;
     tSize = hg->tSize;
-    vertices = hg->hyperedges;
-    hyperedges = hg->vertices;
+    vOffsets = hg->eOffsets;
+    vIncidences = hg->eIncidences;
+    eOffsets = hg->vOffsets;
+    eIncidences = hg->vIncidences;
     dual = hg;
     isDual = true;
 }
+
+
+// Writes the hypergraph into a binary file (see above for the format).
+// Storing the sets of vertices is optional. If they are not stored,
+// load() computes them (in linear time).
+void Hypergraph::save(const string& path, bool withVertexSets) const
+{
+    FileHeader header;
+    memcpy(header.magic, FileMagic, sizeof(FileMagic));
+
+    header.version = FileVersion;
+    header.flags = withVertexSets ? HasVertexSets : 0;
+
+    header.n = vSize;
+    header.m = eSize;
+    header.N = tSize;
+
+    header.eOffsetsPos = align8(sizeof(FileHeader));
+    header.eIncidencesPos = align8(header.eOffsetsPos + (header.m + 1) * sizeof(size_t));
+    header.vOffsetsPos = align8(header.eIncidencesPos + header.N * sizeof(int));
+    header.vIncidencesPos = align8(header.vOffsetsPos + (header.n + 1) * sizeof(size_t));
+
+    if (!withVertexSets)
+    {
+        header.vOffsetsPos = 0;
+        header.vIncidencesPos = 0;
+    }
+
+
+    ofstream out(path, ios::binary | ios::trunc);
+    if (!out) throw runtime_error("Cannot create file " + path + ".");
+
+    // Writes an array at the given position. Fills the gap with zeros.
+    auto writeAt = [&out](uint64_t pos, const void* data, size_t bytes)
+    {
+        static const char zeros[8] = { };
+        out.write(zeros, pos - (uint64_t)out.tellp());
+        out.write((const char*)data, bytes);
+    };
+
+    out.write((const char*)&header, sizeof(FileHeader));
+
+    writeAt(header.eOffsetsPos, eOffsets, (eSize + 1) * sizeof(size_t));
+    writeAt(header.eIncidencesPos, eIncidences, tSize * sizeof(int));
+
+    if (withVertexSets)
+    {
+        writeAt(header.vOffsetsPos, vOffsets, (vSize + 1) * sizeof(size_t));
+        writeAt(header.vIncidencesPos, vIncidences, tSize * sizeof(int));
+    }
+
+    if (!out) throw runtime_error("Cannot write file " + path + ".");
+}
+
+// Loads a hypergraph from a binary file created with save().
+// The file is mapped into memory. Hence, loading does not parse or sort
+// anything. Unless the file is trusted, all sets are validated (one linear
+// pass over the file). A trusted file is only checked for its header and
+// offsets; only the pages that are accessed are read from disk then. Using
+// a trusted file that is corrupted leads to undefined behaviour.
+Hypergraph Hypergraph::load(const string& path, bool trusted)
+{
+    // --- Map file. ---
+
+    size_t fileSize = 0;
+    const char* base = mapFile(path, fileSize);
+    void* map = (void*)base;
+
+    if (fileSize < sizeof(FileHeader))
+    {
+        if (map != nullptr) munmap(map, fileSize);
+        throw runtime_error("Invalid hypergraph file " + path + ".");
+    }
+
+
+    // --- Validate header and offsets. ---
+
+    const FileHeader& header = *(const FileHeader*)base;
+
+    bool hasVSets = (header.flags & HasVertexSets) != 0;
+
+    bool valid =
+        memcmp(header.magic, FileMagic, sizeof(FileMagic)) == 0 &&
+        header.version == FileVersion &&
+        header.n <= INT_MAX && header.m < INT_MAX &&
+        fitsInFile(header.eOffsetsPos, header.m + 1, sizeof(size_t), fileSize) &&
+        fitsInFile(header.eIncidencesPos, header.N, sizeof(int), fileSize) &&
+        (!hasVSets || fitsInFile(header.vOffsetsPos, header.n + 1, sizeof(size_t), fileSize)) &&
+        (!hasVSets || fitsInFile(header.vIncidencesPos, header.N, sizeof(int), fileSize));
+
+    const size_t* eOffsets = (const size_t*)(base + header.eOffsetsPos);
+    const int* eIncidences = (const int*)(base + header.eIncidencesPos);
+    const size_t* vOffsets = (const size_t*)(base + header.vOffsetsPos);
+    const int* vIncidences = (const int*)(base + header.vIncidencesPos);
+
+    valid = valid && validOffsets(eOffsets, header.m + 1, header.N);
+    valid = valid && (!hasVSets || validOffsets(vOffsets, header.n + 1, header.N));
+
+
+    // --- Validate sets. ---
+
+    // Building the sets of vertices reads all incidences anyway. Hence, the
+    // sets of hyperedges are always validated in that case.
+
+    if (valid && (!trusted || !hasVSets))
+    {
+        valid = validSets(eOffsets, eIncidences, header.m, header.n);
+    }
+
+    if (valid && !trusted && hasVSets)
+    {
+        valid =
+            validSets(vOffsets, vIncidences, header.n, header.m) &&
+            validTranspose(eOffsets, eIncidences, header.m, vOffsets, vIncidences, header.n);
+    }
+
+    if (!valid)
+    {
+        munmap(map, fileSize);
+        throw runtime_error("Invalid hypergraph file " + path + ".");
+    }
+
+
+    // --- Create hypergraph. ---
+
+    Hypergraph hg;
+    hg.destruct();
+
+    hg.mapping = map;
+    hg.mapSize = fileSize;
+
+    hg.vSize = header.n;
+    hg.eSize = header.m;
+    hg.tSize = header.N;
+
+    // The hypergraph never changes its arrays. Hence, the read-only mapping is safe.
+    hg.eOffsets = (size_t*)(base + header.eOffsetsPos);
+    hg.eIncidences = (int*)(base + header.eIncidencesPos);
+
+    if (hasVSets)
+    {
+        hg.vOffsets = (size_t*)(base + header.vOffsetsPos);
+        hg.vIncidences = (int*)(base + header.vIncidencesPos);
+    }
+    else
+    {
+        hg.vOffsets = new size_t[hg.vSize + 1]();
+        hg.vIncidences = new int[hg.tSize];
+        hg.buildVertexSets();
+    }
+
+    return hg;
+}
+
+// Reads a hypergraph from a text file in the given format.
+// Large files are parsed in parallel. Empty lines and lines starting with
+// '#' are ignored, as are repeated hyperedge-vertex pairs. Hyperedges
+// without vertices at the end are dropped.
+Hypergraph Hypergraph::read(const string& path, TextFormat format)
+{
+    size_t fileSize = 0;
+    const char* text = mapFile(path, fileSize);
+
+    if (text == nullptr) return Hypergraph();
+
+
+    // --- Split file into chunks. ---
+
+    // Chunks end after a line break. Using more chunks than threads balances
+    // the load if lines differ in length.
+    const size_t MinChunkSize = 1 << 20;
+    size_t chunkCount = min(4 * threadCount(), fileSize / MinChunkSize + 1);
+
+    vector<const char*> bounds(chunkCount + 1);
+    bounds[0] = text;
+    bounds[chunkCount] = text + fileSize;
+
+    for (size_t i = 1; i < chunkCount; i++)
+    {
+        const char* p = max(text + i * (fileSize / chunkCount), bounds[i - 1]);
+        while (p < text + fileSize && *p != '\n') p++;
+        bounds[i] = min(p + 1, text + fileSize);
+    }
+
+
+    // --- Parse chunks in parallel. ---
+
+    vector<vector<intPair>> lists(chunkCount);
+    vector<const char*> errors(chunkCount, nullptr);
+
+    parallelFor(chunkCount, 1, [&](size_t tId, size_t fr, size_t to)
+    {
+        for (size_t i = fr; i < to; i++)
+        {
+            // A pair needs at least 4 characters.
+            lists[i].reserve((bounds[i + 1] - bounds[i]) / 4);
+            errors[i] = parseText(bounds[i], bounds[i + 1], format, lists[i]);
+        }
+    });
+
+    for (size_t i = 0; i < chunkCount; i++)
+    {
+        if (errors[i] == nullptr) continue;
+
+        size_t pos = errors[i] - text;
+        munmap((void*)text, fileSize);
+        throw invalid_argument("Invalid hypergraph file " + path + " at byte " + to_string(pos) + ".");
+    }
+
+
+    // --- Concatenate lists. ---
+
+    vector<size_t> starts(chunkCount + 1, 0);
+    for (size_t i = 0; i < chunkCount; i++)
+    {
+        starts[i + 1] = starts[i] + lists[i].size();
+    }
+
+    vector<intPair> list(starts[chunkCount]);
+
+    parallelFor(chunkCount, 1, [&](size_t tId, size_t fr, size_t to)
+    {
+        for (size_t i = fr; i < to; i++)
+        {
+            copy(lists[i].begin(), lists[i].end(), list.begin() + starts[i]);
+            vector<intPair>().swap(lists[i]);
+        }
+    });
+
+    munmap((void*)text, fileSize);
+
+
+    // --- Build CSR representation. ---
+
+    // Repeated pairs (e.g., repeated lines or vertices) are ignored. Files
+    // written by print() are already sorted without duplicates. Then, this
+    // only checks.
+    if (is_sorted(list.begin(), list.end()))
+    {
+        list.erase(unique(list.begin(), list.end()), list.end());
+    }
+    else
+    {
+        Sorting::sortUnique(list);
+    }
+
+    Hypergraph hg;
+    hg.destruct();
+    hg.build(list.data(), list.size());
+
+    return hg;
+}
@@ -2,22 +2,49 @@
 #define __Hypergraph_H__
 
 #include <ostream>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "../helper.h"
 #include "graph.h"
+#include "idSpan.h"
 
 using namespace std;
 
 
 /**
  *  Represents a hypergraph (or family of sets) as bipartite graph using an adjacency list.
+ *  Both directions of the adjacency list are stored in compressed sparse row (CSR) format.
  */
 class Hypergraph
 {
 public:
 
+    // Formats of text files.
+    //   Sets:  One hyperedge per line, "eId: v1 v2 ..." (as written by print()).
+    //   Pairs: One hyperedge-vertex pair per line, "eId vId".
+    enum class TextFormat
+    {
+        Sets,
+        Pairs
+    };
+
+    // Engines to compute the linegraph.
+    //   Scan:   Counts, for each hyperedge, the neighbours of its vertices in a
+    //           table of size m. Takes time proportional to the sum of d(v)^2.
+    //   Degree: Orders vertices by degree. Heavy vertices are stored as bitsets
+    //           and intersected densely; light vertices are counted in a small
+    //           hash table. Faster on skewed (e.g. power-law) degrees.
+    //   Auto:   Picks one of the above based on the degree distribution.
+    enum class LinegraphEngine
+    {
+        Auto,
+        Scan,
+        Degree
+    };
+
+
     // Default constructor.
     // Creates an empty hypergraph.
     Hypergraph();
@@ -41,7 +68,7 @@ public:
     int getESize() const;
 
     // The combined size of all hyperedges.
-    int getTotalSize() const;
+    size_t getTotalSize() const;
 
 
     // Move assignment.
@@ -49,10 +76,10 @@ public:
 
 
     // Returns the hyperedge with index i.
-    const vector<int>& operator[](const int i) const;
+    IdSpan operator[](const int i) const;
 
     // Returns the hyperedges containing the vertex with index j.
-    const vector<int>& operator()(const int j) const;
+    IdSpan operator()(const int j) const;
 
 
     // Prints the hypergraph as family of sets.
@@ -60,12 +87,33 @@ public:
 
 
     // Computes the weighted linegraph of the hypergraph.
-    Graph getLinegraph() const;
+    // Uses multiple threads.
+    Graph getLinegraph(LinegraphEngine engine = LinegraphEngine::Auto) const;
 
     // Return the dual hypergraph.
     const Hypergraph& getDual() const;
 
 
+    // Writes the hypergraph into a binary file (see below for the format).
+    // Storing the sets of vertices is optional. If they are not stored,
+    // load() computes them (in linear time).
+    void save(const string& path, bool withVertexSets = true) const;
+
+    // Loads a hypergraph from a binary file created with save().
+    // The file is mapped into memory. Hence, loading does not parse or sort
+    // anything. Unless the file is trusted, all sets are validated (one linear
+    // pass over the file). A trusted file is only checked for its header and
+    // offsets; only the pages that are accessed are read from disk then. Using
+    // a trusted file that is corrupted leads to undefined behaviour.
+    static Hypergraph load(const string& path, bool trusted = false);
+
+    // Reads a hypergraph from a text file in the given format.
+    // Large files are parsed in parallel. Empty lines and lines starting with
+    // '#' are ignored, as are repeated hyperedge-vertex pairs. Hyperedges
+    // without vertices at the end are dropped.
+    static Hypergraph read(const string& path, TextFormat format);
+
+
 private:
 
     // Constructor.
@@ -81,7 +129,31 @@ private:
     // Initialises a new hypergraph with n vertices and m hyperedges,
     // and sets the total size to N.
     // Does not create any edges in the bipartite representation.
-    void initialize(const int n, const int m, const int N);
+    void initialize(const int n, const int m, const size_t N);
+
+    // Helper function for constructors.
+    // Creates the CSR representation from a sorted list of N hyperedge-vertex pairs.
+    void build(const intPair* list, const size_t N);
+
+    // Helper function for constructors.
+    // Creates the sets of vertices from the sets of hyperedges.
+    // Assumes that vOffsets[] is allocated and 0 and vIncidences[] is allocated.
+    void buildVertexSets();
+
+    // Returns the heavy vertices, i.e., the (at most 64) vertices with the
+    // largest degree that are in at least m / 8 hyperedges.
+    // They are ordered by non-increasing degree.
+    vector<int> heavyVertices() const;
+
+    // Computes the linegraph with the Scan engine.
+    Graph linegraphScan() const;
+
+    // Computes the linegraph with the Degree engine.
+    // Uses the given list of heavy vertices.
+    Graph linegraphDegree(const vector<int>& heavy) const;
+
+    // Determines if the given array is in the memory-mapped file.
+    bool isMapped(const void* ptr) const;
 
     // Helper function for destructor and similar operations.
     // Frees occupied memory.
@@ -95,14 +167,20 @@ private:
     int eSize = -1;
 
     // The combined size of all hyperedges.
-    int tSize = -1;
+    size_t tSize = 0;
 
 
     // Set of vertices and the hyperedges containing them.
-    vector<int>* vertices = nullptr;
+    // The hyperedges containing vertex v are stored in
+    // vIncidences[vOffsets[v]] to vIncidences[vOffsets[v + 1] - 1].
+    size_t* vOffsets = nullptr;
+    int* vIncidences = nullptr;
 
     // Set of hyperedges and the vertices they contain.
-    vector<int>* hyperedges = nullptr;
+    // The vertices of hyperedge e are stored in
+    // eIncidences[eOffsets[e]] to eIncidences[eOffsets[e + 1] - 1].
+    size_t* eOffsets = nullptr;
+    int* eIncidences = nullptr;
 
 
     // Represents the dual hypergraph.
@@ -110,6 +188,12 @@ private:
 
     // Indicates whether the current hypergraph is created as dual or not.
     bool isDual = false;
+
+
+    // The memory-mapped file if the hypergraph was loaded with load().
+    // Arrays stored in the file point into it and are not freed separately.
+    void* mapping = nullptr;
+    size_t mapSize = 0;
 };
 
 #endif
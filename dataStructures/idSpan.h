@@ -0,0 +1,82 @@
+// Implements a lightweight, read-only view on a contiguous list of IDs.
+
+#ifndef __IdSpan_H__
+#define __IdSpan_H__
+
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+using namespace std;
+
+
+class IdSpan
+{
+    // An IdSpan does not own the IDs it refers to. It is only valid as long as
+    // the underlying storage (e.g., a hypergraph or a vector) is valid and
+    // not modified.
+
+public:
+
+    // Default constructor.
+    // Creates an empty span.
+    IdSpan() { }
+
+    // Constructor.
+    // Creates a span over the given range [first, last).
+    IdSpan(const int* first, const int* last) : ptr(first), length(last - first) { }
+
+    // Constructor.
+    // Creates a span over the given array with the given length.
+    IdSpan(const int* first, size_t len) : ptr(first), length(len) { }
+
+    // Constructor.
+    // Creates a span over the content of the given vector.
+    // Allows to pass vectors to functions that expect a span.
+    IdSpan(const vector<int>& vec) : ptr(vec.data()), length(vec.size()) { }
+
+
+    // The number of IDs in the span.
+    inline size_t size() const { return length; }
+
+    // Determines if the span is empty.
+    inline bool empty() const { return length == 0; }
+
+
+    // Returns the ID at the given index.
+    inline const int& operator[](size_t idx) const
+    {
+        assert(idx < length);
+        return ptr[idx];
+    }
+
+    // Returns the first ID in the span.
+    inline const int& front() const { return operator[](0); }
+
+    // Returns the last ID in the span.
+    inline const int& back() const { return operator[](length - 1); }
+
+    // Returns a pointer to the first ID.
+    inline const int* data() const { return ptr; }
+
+
+    // Iterators (pointers) to the beginning and end of the span.
+    inline const int* begin() const { return ptr; }
+    inline const int* end() const { return ptr + length; }
+
+
+    // Creates a vector containing a copy of all IDs in the span.
+    vector<int> toVector() const { return vector<int>(begin(), end()); }
+
+
+private:
+
+    // Points to the first ID.
+    const int* ptr = nullptr;
+
+    // Number of IDs.
+    size_t length = 0;
+};
+
+#endif
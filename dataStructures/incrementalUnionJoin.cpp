@@ -0,0 +1,1025 @@
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+#include "../algorithms/alphaAcyclic.h"
+#include "../algorithms/sorting.h"
+#include "incrementalUnionJoin.h"
+#include "maxCardinalitySet.h"
+#include "unionFind.h"
+
+
+// Anonymous namespace with helper functions.
+namespace
+{
+    // Computes the intersection of two sorted lists.
+    vector<int> intersect(const vector<int>& a, const vector<int>& b)
+    {
+        vector<int> result;
+        set_intersection(a.begin(), a.end(), b.begin(), b.end(), back_inserter(result));
+        return result;
+    }
+
+    // Counts the elements in the intersection of two sorted lists.
+    size_t intersectionSize(const vector<int>& a, const vector<int>& b)
+    {
+        size_t count = 0;
+        size_t i = 0;
+        size_t j = 0;
+
+        while (i < a.size() && j < b.size())
+        {
+            if (a[i] < b[j]) i++;
+            else if (a[i] > b[j]) j++;
+            else
+            {
+                count++;
+                i++;
+                j++;
+            }
+        }
+
+        return count;
+    }
+
+    // Normalises an edge such that the larger ID comes first.
+    intPair edgeKey(int xId, int yId)
+    {
+        return intPair(max(xId, yId), min(xId, yId));
+    }
+
+    // A weighted candidate edge for Kruskal's algorithm.
+    // Sorting puts heavier edges first. On equal weight, old tree edges come first.
+    struct Candidate
+    {
+        int weight;
+        bool isNew;
+        intPair edge;
+
+        bool operator<(const Candidate& other) const
+        {
+            if (weight != other.weight) return weight > other.weight;
+            if (isNew != other.isNew) return !isNew;
+            return edge < other.edge;
+        }
+    };
+}
+
+
+// Constructor.
+// Creates an empty hypergraph.
+IncrementalUnionJoin::IncrementalUnionJoin() { /* Does nothing. */ }
+
+// Constructor.
+// Starts with the hyperedges of the given hypergraph (keeping their IDs).
+IncrementalUnionJoin::IncrementalUnionJoin(const Hypergraph& hg)
+{
+    const int m = hg.getESize();
+
+    if (m > 0) grow(m - 1);
+
+    for (int eId = 0; eId < m; eId++)
+    {
+        sets[eId] = hg[eId].toVector();
+
+        // Empty hyperedges are treated as removed.
+        if (sets[eId].empty()) continue;
+
+        alive[eId] = true;
+        aliveCount++;
+
+        addToVertices(eId);
+    }
+
+    rebuild();
+}
+
+
+// Adds a hyperedge with the given vertices and returns its ID.
+int IncrementalUnionJoin::insert(vector<int> vList)
+{
+    sort(vList.begin(), vList.end());
+    vList.erase(unique(vList.begin(), vList.end()), vList.end());
+
+    if (vList.empty()) throw invalid_argument("Hyperedge is empty.");
+    if (vList.front() < 0) throw invalid_argument("Negative vertex ID.");
+
+    const int eId = sets.size();
+    grow(eId);
+
+    sets[eId] = move(vList);
+    alive[eId] = true;
+    aliveCount++;
+
+
+    // A cyclic hypergraph has no join tree we could update.
+    if (!acyclic)
+    {
+        addToVertices(eId);
+        rebuild();
+        return eId;
+    }
+
+
+    // --- Remove parts that change. ---
+
+    // Computed before E is added to any list. Hence, the parts do not
+    // contain E yet.
+    for (const vector<int>& S : separatorsIn(eId))
+    {
+        updateParts(S, false);
+    }
+
+
+    // --- Determine components E joins. ---
+
+    // Hyperedges in different components are adjacent (their separator is
+    // empty). E merges all components it touches into one. If the hypergraph
+    // is connected and E touches it, that changes nothing. Otherwise, the
+    // components are determined before the tree changes.
+
+    const bool connected = emptySeps == 0;
+    vector<vector<int>> comps;
+
+    if (!connected)
+    {
+        vector<int> xList;
+        for (const int& vId : sets[eId])
+        {
+            if (vId >= vertexSets.size()) continue;
+            xList.insert(xList.end(), vertexSets[vId].begin(), vertexSets[vId].end());
+        }
+
+        comps = componentsOf(xList);
+    }
+
+
+    // --- Determine touched hyperedges. ---
+
+    // Count for each other hyperedge how many vertices it shares with E.
+    stamp++;
+    vector<int> touched;
+
+    for (const int& vId : sets[eId])
+    {
+        if (vId >= vertexSets.size()) continue;
+
+        for (const int& xId : vertexSets[vId])
+        {
+            if (mark[xId] != stamp)
+            {
+                mark[xId] = stamp;
+                value[xId] = 0;
+                touched.push_back(xId);
+            }
+
+            value[xId]++;
+        }
+    }
+
+    addToVertices(eId);
+
+
+    // --- Update join tree. ---
+
+    if (touched.empty())
+    {
+        // E shares no vertex with the others. Connect it with an empty separator.
+        for (int xId = 0; xId < eId; xId++)
+        {
+            if (!alive[xId]) continue;
+
+            addTreeEdge(eId, xId);
+            break;
+        }
+    }
+    else if (!insertLocal(eId, touched))
+    {
+        // The tree edges between touched hyperedges were not enough. Hence,
+        // consider all tree edges.
+        vector<Candidate> candidates;
+
+        for (const auto& entry : seps)
+        {
+            candidates.push_back({ (int)entry.second.size(), false, entry.first });
+        }
+
+        for (const int& xId : touched)
+        {
+            int weight = intersectionSize(sets[eId], sets[xId]);
+            candidates.push_back({ weight, true, edgeKey(eId, xId) });
+        }
+
+        sort(candidates.begin(), candidates.end());
+
+        UnionFind uf(sets.size());
+        vector<intPair> edges;
+        size_t weight = 0;
+
+        for (const Candidate& c : candidates)
+        {
+            if (uf.findSet(c.edge.first) == uf.findSet(c.edge.second)) continue;
+
+            uf.unionSets(c.edge.first, c.edge.second);
+            edges.push_back(c.edge);
+            weight += c.weight;
+        }
+
+        // --- Check acyclicity. ---
+
+        if (weight != bound)
+        {
+            clear();
+            return eId;
+        }
+
+        setTree(edges);
+    }
+
+
+    // --- Add parts that changed. ---
+
+    for (const vector<int>& S : separatorsIn(eId))
+    {
+        updateParts(S, true);
+    }
+
+
+    // --- Update components. ---
+
+    if (!connected || touched.empty())
+    {
+        // The components E touches are one now.
+        updateCross(comps, false);
+
+        // E is adjacent to all hyperedges of other components.
+        stamp++;
+        mark[eId] = stamp;
+
+        for (const vector<int>& comp : comps)
+        {
+            for (const int& xId : comp) mark[xId] = stamp;
+        }
+
+        for (int xId = 0; xId < sets.size(); xId++)
+        {
+            if (!alive[xId] || mark[xId] == stamp) continue;
+
+            ujg[eId].insert(xId);
+            ujg[xId].insert(eId);
+        }
+    }
+
+    return eId;
+}
+
+// Removes the hyperedge with the given ID.
+void IncrementalUnionJoin::remove(int eId)
+{
+    if (!contains(eId)) throw out_of_range("eId");
+
+
+    // A cyclic hypergraph has no join tree we could update.
+    if (!acyclic)
+    {
+        removeFromVertices(eId);
+
+        sets[eId].clear();
+        alive[eId] = false;
+        aliveCount--;
+
+        rebuild();
+        return;
+    }
+
+
+    // --- Remove parts that change. ---
+
+    for (const vector<int>& S : separatorsIn(eId))
+    {
+        updateParts(S, false);
+    }
+
+    // E is adjacent to all hyperedges of other components. These are exactly
+    // its neighbours which share no vertex with it.
+    if (emptySeps > 0)
+    {
+        stamp++;
+
+        for (const int& vId : sets[eId])
+        {
+            for (const int& xId : vertexSets[vId]) mark[xId] = stamp;
+        }
+
+        vector<int> others;
+        for (const int& xId : ujg[eId])
+        {
+            if (mark[xId] != stamp) others.push_back(xId);
+        }
+
+        for (const int& xId : others)
+        {
+            ujg[eId].erase(xId);
+            ujg[xId].erase(eId);
+        }
+    }
+
+
+    // --- Remove E from tree. ---
+
+    vector<int> treeNeighs;
+    vector<vector<int>> branchSeps;
+
+    for (const intPair& nei : tree[eId])
+    {
+        treeNeighs.push_back(nei.first);
+        branchSeps.push_back(seps.at(edgeKey(eId, nei.first)));
+    }
+
+    for (const int& yId : treeNeighs)
+    {
+        removeTreeEdge(eId, yId);
+    }
+
+    removeFromVertices(eId);
+    alive[eId] = false;
+    aliveCount--;
+
+
+    // --- Reconnect the branches. ---
+
+    // Removing E splits the tree into one branch per neighbour y_b of E. Let
+    // S_b = E ∩ y_b. By the running intersection property, x ∩ E ⊆ S_b for
+    // each hyperedge x in branch b, and hyperedges of different branches only
+    // share vertices of E. Hence, no edge between branches b and c is heavier
+    // than y_b y_c with weight |S_b ∩ S_c|, and it suffices to connect the
+    // neighbours of E. The new tree is a join tree if and only if the S_b
+    // form an acyclic hypergraph.
+    //
+    // We therefore connect the neighbours with a maximum cardinality search
+    // over the S_b: each y_b is attached to the neighbour whose separator
+    // first contained the most recently reached vertex of S_b. If the S_b are
+    // cyclic, the tree is too light (checked below).
+
+    const vector<int>& eSet = sets[eId];
+    const size_t k = treeNeighs.size();
+
+    // For each vertex of E (by index in E), the branches containing it.
+    vector<vector<int>> vBranches(eSet.size());
+    for (size_t b = 0; b < k; b++)
+    {
+        for (int& vId : branchSeps[b])
+        {
+            vId = lower_bound(eSet.begin(), eSet.end(), vId) - eSet.begin();
+            vBranches[vId].push_back(b);
+        }
+    }
+
+    // The first branch containing each vertex and when each branch was reached.
+    vector<int> firstBranch(eSet.size(), -1);
+    vector<int> reached(k, -1);
+
+    // The group of each branch. Branches in different groups are only
+    // connected with empty separators.
+    vector<int> group(k, -1);
+    int groups = 0;
+    int first = -1;
+
+    MaxCardinalitySet branches(k);
+
+    for (int time = 0; !branches.isEmpty(); time++)
+    {
+        int b = branches.removeMax();
+        reached[b] = time;
+
+        int parent = -1;
+        for (const int& vIdx : branchSeps[b])
+        {
+            int c = firstBranch[vIdx];
+            if (c >= 0 && (parent < 0 || reached[c] > reached[parent])) parent = c;
+        }
+
+        if (parent >= 0)
+        {
+            group[b] = group[parent];
+            addTreeEdge(treeNeighs[b], treeNeighs[parent]);
+        }
+        else if (first < 0)
+        {
+            group[b] = groups++;
+            first = b;
+        }
+        else
+        {
+            group[b] = groups++;
+            addTreeEdge(treeNeighs[b], treeNeighs[first]);
+        }
+
+        for (const int& vIdx : branchSeps[b])
+        {
+            if (firstBranch[vIdx] >= 0) continue;
+            firstBranch[vIdx] = b;
+
+            for (const int& c : vBranches[vIdx])
+            {
+                if (reached[c] < 0) branches.increaseSize(c);
+            }
+        }
+    }
+
+
+    // --- Check acyclicity. ---
+
+    if (treeWeight != bound)
+    {
+        sets[eId].clear();
+        clear();
+        return;
+    }
+
+
+    // --- Add parts that changed. ---
+
+    for (const vector<int>& S : separatorsIn(eId))
+    {
+        updateParts(S, true);
+    }
+
+
+    // --- Update components. ---
+
+    // The component of E splits if branches sharing vertices with E are in
+    // different groups. Branches with empty separator were other components already.
+    vector<int> groupStarts(groups, -1);
+    size_t split = 0;
+
+    for (size_t b = 0; b < k; b++)
+    {
+        if (branchSeps[b].empty() || groupStarts[group[b]] >= 0) continue;
+
+        groupStarts[group[b]] = treeNeighs[b];
+        split++;
+    }
+
+    if (split > 1)
+    {
+        groupStarts.erase(std::remove(groupStarts.begin(), groupStarts.end(), -1), groupStarts.end());
+        updateCross(componentsOf(groupStarts), true);
+    }
+
+    sets[eId].clear();
+    assert(ujg[eId].empty());
+}
+
+// Recomputes join tree and union join graph from scratch.
+void IncrementalUnionJoin::rebuild()
+{
+    rebuilds++;
+
+    clear();
+    acyclic = true;
+
+    if (aliveCount == 0) return;
+
+
+    // --- Build hypergraph. ---
+
+    // Hyperedges and vertices get consecutive IDs. The order stays the same.
+
+    vector<int> eIds;
+    for (int eId = 0; eId < sets.size(); eId++)
+    {
+        if (alive[eId]) eIds.push_back(eId);
+    }
+
+    vector<int> vNewIds(vertexSets.size(), -1);
+    for (int vId = 0, nId = 0; vId < vertexSets.size(); vId++)
+    {
+        if (!vertexSets[vId].empty()) vNewIds[vId] = nId++;
+    }
+
+    vector<intPair> pairs;
+    for (int i = 0; i < eIds.size(); i++)
+    {
+        for (const int& vId : sets[eIds[i]])
+        {
+            pairs.push_back(intPair(i, vNewIds[vId]));
+        }
+    }
+
+    Hypergraph hg(pairs);
+
+
+    // --- Compute join tree. ---
+
+    vector<int> joinTree = AlphaAcyclic::getJoinTree(hg);
+
+    if (joinTree.empty())
+    {
+        acyclic = false;
+        return;
+    }
+
+    // Components of a disconnected hypergraph have their own roots.
+    vector<int> roots;
+
+    for (int i = 0; i < joinTree.size(); i++)
+    {
+        if (joinTree[i] < 0) roots.push_back(eIds[i]);
+        else addTreeEdge(eIds[i], eIds[joinTree[i]]);
+    }
+
+    for (size_t i = 1; i < roots.size(); i++)
+    {
+        addTreeEdge(roots[0], roots[i]);
+    }
+
+    assert(treeWeight == bound);
+
+
+    // --- Compute union join graph. ---
+
+    vector<vector<int>> sepList;
+    for (const auto& entry : seps)
+    {
+        sepList.push_back(entry.second);
+    }
+
+    sort(sepList.begin(), sepList.end());
+    sepList.erase(unique(sepList.begin(), sepList.end()), sepList.end());
+
+    for (const vector<int>& S : sepList)
+    {
+        updateParts(S, true);
+    }
+}
+
+
+// Determines if the current hypergraph is acyclic.
+// If not, join tree and union join graph are empty.
+bool IncrementalUnionJoin::isAcyclic() const
+{
+    return acyclic;
+}
+
+// Determines if the hyperedge with the given ID exists (i.e., was not removed).
+bool IncrementalUnionJoin::contains(int eId) const
+{
+    return eId >= 0 && eId < sets.size() && alive[eId];
+}
+
+// The number of hyperedge IDs used so far (including removed hyperedges).
+size_t IncrementalUnionJoin::size() const
+{
+    return sets.size();
+}
+
+// The number of full rebuilds so far (including the initial one).
+size_t IncrementalUnionJoin::rebuildCount() const
+{
+    return rebuilds;
+}
+
+
+// Returns the vertices of the hyperedge with the given ID.
+const vector<int>& IncrementalUnionJoin::operator[](const int eId) const
+{
+    if (eId < 0 || eId >= sets.size()) throw out_of_range("eId");
+
+    return sets[eId];
+}
+
+// Returns the neighbours of the given hyperedge in the join tree.
+// Each neighbour is paired with the size of the separator.
+const vector<intPair>& IncrementalUnionJoin::joinTree(const int eId) const
+{
+    if (eId < 0 || eId >= sets.size()) throw out_of_range("eId");
+
+    return tree[eId];
+}
+
+// The separators of the join tree.
+// Maps each edge (larger ID, smaller ID) of the join tree to the intersection of its endpoints.
+const map<intPair, vector<int>>& IncrementalUnionJoin::separators() const
+{
+    return seps;
+}
+
+// Returns the union join graph. Vertex IDs are the hyperedge IDs.
+Graph IncrementalUnionJoin::unionJoinGraph() const
+{
+    vector<intPair> eList;
+
+    for (int xId = 0; xId < ujg.size(); xId++)
+    {
+        for (const int& yId : ujg[xId])
+        {
+            if (yId < xId) eList.push_back(intPair(xId, yId));
+        }
+    }
+
+    Sorting::radixSort(eList);
+
+    // A loop at the largest ID ensures that the graph has all vertices.
+    if (ujg.size() > 0)
+    {
+        eList.push_back(intPair(ujg.size() - 1, ujg.size() - 1));
+    }
+
+    return Graph(move(eList), false);
+}
+
+
+// Adds the given hyperedge to the lists of its vertices.
+void IncrementalUnionJoin::addToVertices(int eId)
+{
+    for (const int& vId : sets[eId])
+    {
+        if (vId >= vertexSets.size()) vertexSets.resize(vId + 1);
+
+        if (!vertexSets[vId].empty()) bound++;
+        vertexSets[vId].push_back(eId);
+    }
+}
+
+// Removes the given hyperedge from the lists of its vertices.
+void IncrementalUnionJoin::removeFromVertices(int eId)
+{
+    for (const int& vId : sets[eId])
+    {
+        vector<int>& xList = vertexSets[vId];
+
+        auto it = find(xList.begin(), xList.end(), eId);
+        *it = xList.back();
+        xList.pop_back();
+
+        if (!xList.empty()) bound--;
+    }
+}
+
+
+// Adds an edge to the join tree.
+void IncrementalUnionJoin::addTreeEdge(int xId, int yId)
+{
+    vector<int> sep = intersect(sets[xId], sets[yId]);
+    int weight = sep.size();
+
+    tree[xId].push_back(intPair(yId, weight));
+    tree[yId].push_back(intPair(xId, weight));
+
+    seps[edgeKey(xId, yId)] = move(sep);
+
+    treeWeight += weight;
+    if (weight == 0) emptySeps++;
+}
+
+// Removes an edge from the join tree.
+void IncrementalUnionJoin::removeTreeEdge(int xId, int yId)
+{
+    auto isX = [xId](const intPair& p) { return p.first == xId; };
+    auto isY = [yId](const intPair& p) { return p.first == yId; };
+
+    vector<intPair>& xNeighs = tree[xId];
+    vector<intPair>& yNeighs = tree[yId];
+
+    xNeighs.erase(find_if(xNeighs.begin(), xNeighs.end(), isY));
+    yNeighs.erase(find_if(yNeighs.begin(), yNeighs.end(), isX));
+
+    auto it = seps.find(edgeKey(xId, yId));
+    size_t weight = it->second.size();
+
+    treeWeight -= weight;
+    if (weight == 0) emptySeps--;
+
+    seps.erase(it);
+}
+
+// Replaces the join tree by a tree with the given edges.
+// Keeps edges which are in both trees untouched.
+void IncrementalUnionJoin::setTree(const vector<intPair>& edges)
+{
+    vector<intPair> newKeys;
+    for (const intPair& e : edges)
+    {
+        newKeys.push_back(edgeKey(e.first, e.second));
+    }
+
+    sort(newKeys.begin(), newKeys.end());
+
+    // Remove edges which are not in the new tree.
+    vector<intPair> oldKeys;
+    for (const auto& entry : seps)
+    {
+        oldKeys.push_back(entry.first);
+    }
+
+    for (const intPair& key : oldKeys)
+    {
+        if (binary_search(newKeys.begin(), newKeys.end(), key)) continue;
+        removeTreeEdge(key.first, key.second);
+    }
+
+    // Add edges which are not in the old tree.
+    for (const intPair& key : newKeys)
+    {
+        if (seps.count(key) > 0) continue;
+        addTreeEdge(key.first, key.second);
+    }
+}
+
+
+// Tries to update the join tree for an inserted hyperedge E by only
+// changing tree edges between the touched hyperedges (those sharing a vertex
+// with E). Expects that the touched hyperedges are marked and their values are
+// the sizes of their intersections with E. Returns false (and keeps the tree
+// as it is) if that does not result in a join tree.
+bool IncrementalUnionJoin::insertLocal(int eId, const vector<int>& touched)
+{
+    // If the touched hyperedges form a subtree, each new cycle is within
+    // that subtree and E. Then, a maximum spanning tree of the subtree and
+    // the edges of E gives a tree with maximum weight. Otherwise, cycles
+    // can contain other tree edges and we let the caller handle it.
+
+    vector<Candidate> candidates;
+    size_t oldEdges = 0;
+
+    for (const int& xId : touched)
+    {
+        candidates.push_back({ value[xId], true, edgeKey(eId, xId) });
+
+        for (const intPair& nei : tree[xId])
+        {
+            const int& yId = nei.first;
+
+            if (yId > xId || mark[yId] != stamp) continue;
+
+            candidates.push_back({ nei.second, false, edgeKey(xId, yId) });
+            oldEdges++;
+        }
+    }
+
+    if (oldEdges + 1 != touched.size()) return false;
+
+
+    // --- Kruskal's algorithm on local indices. ---
+
+    for (size_t i = 0; i < touched.size(); i++)
+    {
+        value[touched[i]] = i;
+    }
+
+    mark[eId] = stamp;
+    value[eId] = touched.size();
+
+    sort(candidates.begin(), candidates.end());
+
+    UnionFind uf(touched.size() + 1);
+    vector<intPair> removed;
+    vector<intPair> added;
+    size_t weight = treeWeight;
+
+    for (const Candidate& c : candidates)
+    {
+        size_t xIdx = value[c.edge.first];
+        size_t yIdx = value[c.edge.second];
+
+        if (uf.findSet(xIdx) != uf.findSet(yIdx))
+        {
+            uf.unionSets(xIdx, yIdx);
+
+            if (c.isNew)
+            {
+                added.push_back(c.edge);
+                weight += c.weight;
+            }
+        }
+        else if (!c.isNew)
+        {
+            removed.push_back(c.edge);
+            weight -= c.weight;
+        }
+    }
+
+    if (weight != bound) return false;
+
+
+    // --- Update tree. ---
+
+    for (const intPair& e : removed)
+    {
+        removeTreeEdge(e.first, e.second);
+    }
+
+    for (const intPair& e : added)
+    {
+        addTreeEdge(e.first, e.second);
+    }
+
+    return true;
+}
+
+// Determines all non-empty separators S ⊆ E of the join tree (without duplicates).
+vector<vector<int>> IncrementalUnionJoin::separatorsIn(int eId)
+{
+    // A non-empty separator S ⊆ E is between two hyperedges which share a
+    // vertex with E. Hence, we only check the tree edges of those.
+
+    const vector<int>& eSet = sets[eId];
+    vector<vector<int>> result;
+
+    stamp++;
+
+    for (const int& vId : eSet)
+    {
+        if (vId >= vertexSets.size()) continue;
+
+        for (const int& xId : vertexSets[vId])
+        {
+            if (mark[xId] == stamp) continue;
+            mark[xId] = stamp;
+
+            for (const intPair& nei : tree[xId])
+            {
+                // Each edge is checked from its larger endpoint (or from E).
+                const int& yId = nei.first;
+                if (yId > xId && mark[yId] == stamp) continue;
+
+                const vector<int>& sep = seps.at(edgeKey(xId, yId));
+                if (sep.empty()) continue;
+
+                if (includes(eSet.begin(), eSet.end(), sep.begin(), sep.end()))
+                {
+                    result.push_back(sep);
+                }
+            }
+        }
+    }
+
+    sort(result.begin(), result.end());
+    result.erase(unique(result.begin(), result.end()), result.end());
+
+    return result;
+}
+
+// Adds or removes all edges of the union join graph whose endpoints intersect in exactly S.
+void IncrementalUnionJoin::updateParts(const vector<int>& S, bool add)
+{
+    // --- Determine X_S, i.e., all hyperedges containing S. ---
+
+    vector<int> xList;
+
+    if (S.empty())
+    {
+        for (int xId = 0; xId < sets.size(); xId++)
+        {
+            if (alive[xId]) xList.push_back(xId);
+        }
+    }
+    else
+    {
+        // Only check the hyperedges of the vertex in S with fewest hyperedges.
+        int minVId = S[0];
+        for (const int& vId : S)
+        {
+            if (vertexSets[vId].size() < vertexSets[minVId].size()) minVId = vId;
+        }
+
+        for (const int& xId : vertexSets[minVId])
+        {
+            const vector<int>& xSet = sets[xId];
+            if (includes(xSet.begin(), xSet.end(), S.begin(), S.end())) xList.push_back(xId);
+        }
+    }
+
+    stamp++;
+    for (const int& xId : xList)
+    {
+        mark[xId] = stamp;
+        value[xId] = -1;
+    }
+
+
+    // --- Split X_S at edges with separator S. ---
+
+    // X_S is a subtree. An edge in it has separator S if and only if its
+    // separator has the same size as S.
+
+    vector<vector<int>> parts;
+
+    for (const int& xId : xList)
+    {
+        if (value[xId] >= 0) continue;
+
+        parts.push_back(vector<int>());
+        vector<int>& part = parts.back();
+
+        value[xId] = parts.size() - 1;
+        part.push_back(xId);
+
+        for (size_t i = 0; i < part.size(); i++)
+        {
+            for (const intPair& nei : tree[part[i]])
+            {
+                const int& yId = nei.first;
+
+                if (mark[yId] != stamp || value[yId] >= 0) continue;
+                if (nei.second == S.size()) continue;
+
+                value[yId] = value[xId];
+                part.push_back(yId);
+            }
+        }
+    }
+
+
+    // --- Connect different parts. ---
+
+    updateCross(parts, add);
+}
+
+// Determines the components (hyperedges connected by tree edges with
+// non-empty separators) which contain the given hyperedges.
+vector<vector<int>> IncrementalUnionJoin::componentsOf(const vector<int>& xList)
+{
+    stamp++;
+    vector<vector<int>> comps;
+
+    for (const int& xId : xList)
+    {
+        if (mark[xId] == stamp) continue;
+
+        comps.push_back(vector<int>());
+        vector<int>& comp = comps.back();
+
+        mark[xId] = stamp;
+        comp.push_back(xId);
+
+        for (size_t i = 0; i < comp.size(); i++)
+        {
+            for (const intPair& nei : tree[comp[i]])
+            {
+                const int& yId = nei.first;
+                if (mark[yId] == stamp || nei.second == 0) continue;
+
+                mark[yId] = stamp;
+                comp.push_back(yId);
+            }
+        }
+    }
+
+    return comps;
+}
+
+// Adds or removes all edges of the union join graph between hyperedges of different parts.
+void IncrementalUnionJoin::updateCross(const vector<vector<int>>& parts, bool add)
+{
+    for (size_t i = 0; i < parts.size(); i++)
+    {
+        for (size_t j = i + 1; j < parts.size(); j++)
+        {
+            for (const int& xId : parts[i])
+            {
+                for (const int& yId : parts[j])
+                {
+                    if (add)
+                    {
+                        ujg[xId].insert(yId);
+                        ujg[yId].insert(xId);
+                    }
+                    else
+                    {
+                        ujg[xId].erase(yId);
+                        ujg[yId].erase(xId);
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+// Clears join tree and union join graph. Used if the hypergraph becomes cyclic.
+void IncrementalUnionJoin::clear()
+{
+    for (vector<intPair>& neighs : tree) neighs.clear();
+    for (unordered_set<int>& neighs : ujg) neighs.clear();
+
+    seps.clear();
+    treeWeight = 0;
+    emptySeps = 0;
+
+    acyclic = false;
+}
+
+// Increases the size of all per-hyperedge lists to fit the given ID.
+void IncrementalUnionJoin::grow(int eId)
+{
+    if (eId < sets.size()) return;
+
+    sets.resize(eId + 1);
+    alive.resize(eId + 1, false);
+    tree.resize(eId + 1);
+    ujg.resize(eId + 1);
+    mark.resize(eId + 1, 0);
+    value.resize(eId + 1, 0);
+}
@@ -0,0 +1,169 @@
+// Maintains the join tree and union join graph of a hypergraph under hyperedge insertions and deletions.
+
+#ifndef __IncrementalUnionJoin_H__
+#define __IncrementalUnionJoin_H__
+
+
+#include <map>
+#include <unordered_set>
+#include <vector>
+
+#include "../helper.h"
+#include "graph.h"
+#include "hypergraph.h"
+
+
+using namespace std;
+
+
+// Maintains the join tree, separators, and union join graph of a hypergraph
+// under hyperedge insertions and deletions.
+class IncrementalUnionJoin
+{
+    // Background:
+    //   - A spanning tree T of the hyperedges is a join tree if and only if its
+    //     weight (the sum of the sizes of all separators) equals the sum of
+    //     d(v) - 1 over all vertices v, where d(v) is the number of
+    //     hyperedges containing v. Hence, a maximum weight spanning tree of
+    //     the line graph is a join tree if and only if the hypergraph is
+    //     acyclic.
+    //   - For a separator S of T, let X_S be the hyperedges containing S.
+    //     Removing all edges with separator S from T splits X_S into parts.
+    //     Two hyperedges are adjacent in the union join graph if and only if
+    //     they are in different parts for S = their intersection.
+    //   - If a hyperedge E is added or removed, all edges which T gains or
+    //     loses have a separator S ⊆ E. Only the parts for separators
+    //     S ⊆ E change. All others stay as they are.
+    //
+    // Hyperedge IDs are never reused. Removed hyperedges stay isolated
+    // vertices of the union join graph. If the hypergraph is disconnected,
+    // the join tree connects its components with empty separators.
+
+public:
+
+    // Constructor.
+    // Creates an empty hypergraph.
+    IncrementalUnionJoin();
+
+    // Constructor.
+    // Starts with the hyperedges of the given hypergraph (keeping their IDs).
+    IncrementalUnionJoin(const Hypergraph& hg);
+
+
+    // Adds a hyperedge with the given vertices and returns its ID.
+    int insert(vector<int> vList);
+
+    // Removes the hyperedge with the given ID.
+    void remove(int eId);
+
+    // Recomputes join tree and union join graph from scratch.
+    void rebuild();
+
+
+    // Determines if the current hypergraph is acyclic.
+    // If not, join tree and union join graph are empty.
+    bool isAcyclic() const;
+
+    // Determines if the hyperedge with the given ID exists (i.e., was not removed).
+    bool contains(int eId) const;
+
+    // The number of hyperedge IDs used so far (including removed hyperedges).
+    size_t size() const;
+
+    // The number of full rebuilds so far (including the initial one).
+    size_t rebuildCount() const;
+
+
+    // Returns the vertices of the hyperedge with the given ID.
+    const vector<int>& operator[](const int eId) const;
+
+    // Returns the neighbours of the given hyperedge in the join tree.
+    // Each neighbour is paired with the size of the separator.
+    const vector<intPair>& joinTree(const int eId) const;
+
+    // The separators of the join tree.
+    // Maps each edge (larger ID, smaller ID) of the join tree to the intersection of its endpoints.
+    const map<intPair, vector<int>>& separators() const;
+
+    // Returns the union join graph. Vertex IDs are the hyperedge IDs.
+    Graph unionJoinGraph() const;
+
+
+private:
+
+    // The vertices of each hyperedge (sorted). Empty for removed hyperedges.
+    vector<vector<int>> sets;
+    vector<bool> alive;
+    size_t aliveCount = 0;
+
+    // The hyperedges containing each vertex (not sorted).
+    vector<vector<int>> vertexSets;
+
+    // Sum of d(v) - 1 over all vertices v with d(v) > 0.
+    size_t bound = 0;
+
+
+    bool acyclic = true;
+    size_t rebuilds = 0;
+
+
+    // Join tree as adjacency list. Pairs (neighbour, separator size).
+    vector<vector<intPair>> tree;
+    map<intPair, vector<int>> seps;
+
+    // Sum of all separator sizes.
+    size_t treeWeight = 0;
+
+    // Number of empty separators.
+    size_t emptySeps = 0;
+
+
+    // Union join graph as adjacency list.
+    vector<unordered_set<int>> ujg;
+
+
+    // Marks hyperedges. A hyperedge is marked if its entry is equal to stamp.
+    vector<size_t> mark;
+    size_t stamp = 0;
+
+    // Helper values for marked hyperedges (e.g., counters).
+    vector<int> value;
+
+
+    // Adds or removes the given hyperedge to the lists of its vertices.
+    void addToVertices(int eId);
+    void removeFromVertices(int eId);
+
+    // Adds or removes an edge to or from the join tree.
+    void addTreeEdge(int xId, int yId);
+    void removeTreeEdge(int xId, int yId);
+
+    // Replaces the join tree by a tree with the given edges.
+    // Keeps edges which are in both trees untouched.
+    void setTree(const vector<intPair>& edges);
+
+    // Tries to update the join tree for an inserted hyperedge by only
+    // changing tree edges between hyperedges which share a vertex with it.
+    bool insertLocal(int eId, const vector<int>& touched);
+
+    // Determines all non-empty separators S ⊆ E of the join tree (without duplicates).
+    vector<vector<int>> separatorsIn(int eId);
+
+    // Adds or removes all edges of the union join graph whose endpoints intersect in exactly S.
+    void updateParts(const vector<int>& S, bool add);
+
+    // Determines the components (hyperedges connected by tree edges with
+    // non-empty separators) which contain the given hyperedges.
+    vector<vector<int>> componentsOf(const vector<int>& xList);
+
+    // Adds or removes all edges of the union join graph between hyperedges of different parts.
+    void updateCross(const vector<vector<int>>& parts, bool add);
+
+    // Clears join tree and union join graph. Used if the hypergraph becomes cyclic.
+    void clear();
+
+    // Increases the size of all per-hyperedge lists to fit the given ID.
+    void grow(int eId);
+};
+
+#endif
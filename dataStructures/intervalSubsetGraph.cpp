@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include "intervalSubsetGraph.h"
+
+
+// Default constructor.
+// Creates an empty subset graph.
+IntervalSubsetGraph::IntervalSubsetGraph() { /* Does nothing. */ }
+
+// Constructor.
+// Takes ownership of a join path and, for each hyperedge (by ID), the
+// first and last index (inclusive) of its range on the join path.
+IntervalSubsetGraph::IntervalSubsetGraph(vector<int>&& joinPath, vector<int>&& rangeFr, vector<int>&& rangeTo) :
+    path(move(joinPath)),
+    rFr(move(rangeFr)),
+    rTo(move(rangeTo))
+{
+    const size_t m = path.size();
+
+    if (rFr.size() != m || rTo.size() != m)
+    {
+        throw logic_error("Size of given listst not equal.");
+    }
+
+    pathIdx.resize(m);
+    for (size_t i = 0; i < m; i++)
+    {
+        pathIdx[path[i]] = i;
+    }
+
+    for (size_t eId = 0; eId < m; eId++)
+    {
+        if (rFr[eId] < 0 || rFr[eId] > pathIdx[eId] || rTo[eId] < pathIdx[eId] || (size_t)rTo[eId] >= m)
+        {
+            throw logic_error("Range does not contain its hyperedge.");
+        }
+    }
+}
+
+
+// The number of hyperedges.
+size_t IntervalSubsetGraph::size() const
+{
+    return path.size();
+}
+
+// The number of edges in the subset graph.
+size_t IntervalSubsetGraph::edgeCount() const
+{
+    size_t count = 0;
+
+    for (size_t eId = 0; eId < path.size(); eId++)
+    {
+        count += rTo[eId] - rFr[eId];
+    }
+
+    return count;
+}
+
+// The join path the ranges refer to.
+IdSpan IntervalSubsetGraph::joinPath() const
+{
+    return IdSpan(path);
+}
+
+
+// Determines if hyperedge x is a subset of hyperedge y (and x != y).
+// Takes constant time.
+bool IntervalSubsetGraph::isSubset(int xId, int yId) const
+{
+    if (xId == yId) return false;
+
+    int yIdx = pathIdx[yId];
+    return rFr[xId] <= yIdx && yIdx <= rTo[xId];
+}
+
+// Returns the range of hyperedge x on the join path. It contains all
+// supersets of x as well as x itself.
+IdSpan IntervalSubsetGraph::supersetRange(int xId) const
+{
+    return IdSpan(path.data() + rFr[xId], path.data() + rTo[xId] + 1);
+}
+
+// Calls func(y) for each superset y of hyperedge x.
+void IntervalSubsetGraph::forEachSuperset(int xId, const function<void(int)>& func) const
+{
+    for (const int& yId : supersetRange(xId))
+    {
+        if (yId != xId) func(yId);
+    }
+}
+
+
+// Sends all edges (x, y), where y is a subset of x, to the given sink.
+// Edges are not sorted.
+void IntervalSubsetGraph::expand(const edgeSink& sink) const
+{
+    for (size_t i = 0; i < path.size(); i++)
+    {
+        int eId = path[i];
+
+        forEachSuperset(eId, [&sink, eId](int fId) { sink(fId, eId); });
+    }
+}
+
+// Returns all edges (x, y), where y is a subset of x, as sorted list.
+// Uses multiple threads. Edges are written directly to their final position.
+vector<intPair> IntervalSubsetGraph::toEdges() const
+{
+    // The subsets of a hyperedge X are all hyperedges whose range contains the
+    // index of X (except X itself). Counting how many ranges contain each
+    // index gives the number of edges (X, .) and, using a prefix sum, where
+    // they start in the result.
+    //
+    // The join path is split into blocks. A block only writes the edges (X, .)
+    // for hyperedges X in it. It visits all hyperedges Y in order of their ID
+    // and adds Y to each X in the part of Y's range that overlaps the block.
+    // Hence, the subsets of each X are sorted as well.
+
+    const size_t m = path.size();
+
+
+    // --- Count edges. ---
+
+    vector<int> cover(m + 1, 0);
+    for (size_t yId = 0; yId < m; yId++)
+    {
+        cover[rFr[yId]]++;
+        cover[rTo[yId] + 1]--;
+    }
+
+    for (size_t i = 1; i < m; i++)
+    {
+        cover[i] += cover[i - 1];
+    }
+
+    // Position of the next edge (X, .) in the result. Starts at the first one.
+    vector<size_t> next(m + 1, 0);
+    for (size_t xId = 0; xId < m; xId++)
+    {
+        next[xId + 1] = next[xId] + cover[pathIdx[xId]] - 1;
+    }
+
+    vector<intPair> result(next[m]);
+
+
+    // --- Fill result. ---
+
+    // Each block scans all ranges. A few blocks per thread balance the load.
+    const size_t blockSize = max(m / (4 * threadCount()) + 1, (size_t)256);
+
+    parallelFor(m, blockSize, [&](size_t tId, size_t fr, size_t to)
+    {
+        for (size_t yId = 0; yId < m; yId++)
+        {
+            int yFr = max(rFr[yId], (int)fr);
+            int yTo = min(rTo[yId], (int)to - 1);
+
+            for (int i = yFr; i <= yTo; i++)
+            {
+                int xId = path[i];
+                if (xId == yId) continue;
+
+                result[next[xId]] = intPair(xId, yId);
+                next[xId]++;
+            }
+        }
+    });
+
+    return result;
+}
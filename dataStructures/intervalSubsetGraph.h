@@ -0,0 +1,84 @@
+// Represents the subset graph of an interval hypergraph without listing its edges.
+
+#ifndef __IntervalSubsetGraph_H__
+#define __IntervalSubsetGraph_H__
+
+
+#include <functional>
+#include <vector>
+
+#include "../helper.h"
+#include "idSpan.h"
+
+
+using namespace std;
+
+
+// Represents the subset graph of an interval hypergraph without listing its edges.
+class IntervalSubsetGraph
+{
+    // In an interval hypergraph, the supersets of a hyperedge X form a
+    // contiguous range on the join path that contains X. We store the join
+    // path and, for each hyperedge, the first and last index of its range.
+    // That needs O(m) memory, while the subset graph can have O(m^2) edges.
+    // Two equal hyperedges are supersets of each other.
+
+public:
+
+    // Receives an edge (x, y) of the subset graph, i.e., y is a subset of x.
+    typedef function<void(int, int)> edgeSink;
+
+
+    // Default constructor.
+    // Creates an empty subset graph.
+    IntervalSubsetGraph();
+
+    // Constructor.
+    // Takes ownership of a join path and, for each hyperedge (by ID), the
+    // first and last index (inclusive) of its range on the join path.
+    IntervalSubsetGraph(vector<int>&& joinPath, vector<int>&& rangeFr, vector<int>&& rangeTo);
+
+
+    // The number of hyperedges.
+    size_t size() const;
+
+    // The number of edges in the subset graph.
+    size_t edgeCount() const;
+
+    // The join path the ranges refer to.
+    IdSpan joinPath() const;
+
+
+    // Determines if hyperedge x is a subset of hyperedge y (and x != y).
+    // Takes constant time.
+    bool isSubset(int xId, int yId) const;
+
+    // Returns the range of hyperedge x on the join path. It contains all
+    // supersets of x as well as x itself.
+    IdSpan supersetRange(int xId) const;
+
+    // Calls func(y) for each superset y of hyperedge x.
+    void forEachSuperset(int xId, const function<void(int)>& func) const;
+
+
+    // Sends all edges (x, y), where y is a subset of x, to the given sink.
+    // Edges are not sorted.
+    void expand(const edgeSink& sink) const;
+
+    // Returns all edges (x, y), where y is a subset of x, as sorted list.
+    // Uses multiple threads. Edges are written directly to their final position.
+    vector<intPair> toEdges() const;
+
+
+private:
+
+    // The join path and the index of each hyperedge in it.
+    vector<int> path;
+    vector<int> pathIdx;
+
+    // The range of hyperedge X is [rFr[X], rTo[X]] on the join path.
+    vector<int> rFr;
+    vector<int> rTo;
+};
+
+#endif
@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
 #include "maxCardinalitySet.h"
 
 
@@ -82,3 +86,116 @@ bool MaxCardinalitySet::isEmpty()
 {
     return setList.size() <= 0;
 }
+
+
+
+// --- Packed Variant ---
+
+// Default constructor.
+// Creates empty set.
+PackedMaxCardinalitySet::PackedMaxCardinalitySet() { /* Do nothing. */ }
+
+// Contructor.
+// Creates the data structure with the given number of sets.
+// Set IDs are in [0, k). Each set has size 0 and never grows beyond maxSize.
+PackedMaxCardinalitySet::PackedMaxCardinalitySet(size_t k, size_t maxSize)
+{
+    assert(k <= numeric_limits<int32_t>::max());
+    assert(maxSize < numeric_limits<int32_t>::max() - 1);
+
+
+    // --- Create k empty sets. ---
+
+    setList.resize(k);
+    setInfo.resize(k);
+
+    for (int32_t i = 0; i < k; i++)
+    {
+        setList[i] = i;
+        setInfo[i] = { i, 0 };
+    }
+
+    // Sizes 0 to maxSize + 1; the last one is only read to keep increase() free
+    // of bounds checks. All groups end at the last set.
+    endIndices.resize(maxSize + 2, (int32_t)k - 1);
+    topSize = 0;
+}
+
+
+// Increases the size of the set with the given ID by 1.
+void PackedMaxCardinalitySet::increaseSize(int setId)
+{
+    assert(setInfo[setId].idx >= 0);
+    increase(setInfo[setId]);
+}
+
+// Increases the size of each given set by 1.
+// Sets that were removed already are ignored.
+void PackedMaxCardinalitySet::increaseSizes(const IdSpan& setIds)
+{
+    for (const int& setId : setIds)
+    {
+        SetInfo& info = setInfo[setId];
+        if (info.idx < 0) continue;
+
+        increase(info);
+    }
+}
+
+// Increases the size of the given (not removed) set by 1.
+void PackedMaxCardinalitySet::increase(SetInfo& info)
+{
+    int32_t size = info.size;
+    assert(size + 2 < endIndices.size());
+
+    // Last set with same size.
+    int32_t last = endIndices[size];
+    int32_t lastId = setList[last];
+
+    // Swap elements.
+    setList[last] = setList[info.idx];
+    setList[info.idx] = lastId;
+    setInfo[lastId].idx = info.idx;
+    info.idx = last;
+
+    // Increase size. The group of the new size ends at the last set already
+    // if it was empty (see endIndices).
+    endIndices[size] = last - 1;
+    info.size = size + 1;
+
+    topSize = max(topSize, size + 1);
+    endIndices[topSize + 1] = (int32_t)setList.size() - 1;
+}
+
+// Removes and returns a set with maximum size.
+int PackedMaxCardinalitySet::removeMax()
+{
+    // Find and update set.
+    int32_t lastId = setList.back();
+    setInfo[lastId].idx = -1;
+    setList.pop_back();
+
+    // All groups from the new largest size onwards end at the new last set.
+    int32_t newLast = (int32_t)setList.size() - 1;
+    int32_t newTop = newLast < 0 ? 0 : setInfo[setList[newLast]].size;
+
+    for (int32_t size = newTop; size <= topSize + 1; size++)
+    {
+        endIndices[size] = newLast;
+    }
+
+    topSize = newTop;
+    return lastId;
+}
+
+// Returns the size of the given set. Sets keep their size when removed.
+int PackedMaxCardinalitySet::sizeOf(int setId) const
+{
+    return setInfo[setId].size;
+}
+
+// Steates if the set is empty or not.
+bool PackedMaxCardinalitySet::isEmpty() const
+{
+    return setList.empty();
+}
@@ -4,9 +4,11 @@
 #define __MaxCardinalitySet_H__
 
 
+#include <cstdint>
 #include <vector>
 
 #include "../helper.h"
+#include "idSpan.h"
 
 
 using namespace std;
@@ -49,4 +51,68 @@ private:
 
 };
 
+
+// A variant of MaxCardinalitySet for known maximum set sizes. All fields are
+// 32 bits wide and the index and size of a set share a cache line. The ends of
+// all possible size groups are allocated in advance; increasing a size
+// therefore needs no bounds check. Removes sets in the same order as
+// MaxCardinalitySet.
+class PackedMaxCardinalitySet
+{
+public:
+
+    // Default constructor.
+    // Creates empty set.
+    PackedMaxCardinalitySet();
+
+    // Contructor.
+    // Creates the data structure with the given number of sets.
+    // Set IDs are in [0, k). Each set has size 0 and never grows beyond maxSize.
+    PackedMaxCardinalitySet(size_t k, size_t maxSize);
+
+
+    // Increases the size of the set with the given ID by 1.
+    void increaseSize(int setId);
+
+    // Increases the size of each given set by 1.
+    // Sets that were removed already are ignored.
+    void increaseSizes(const IdSpan& setIds);
+
+    // Removes and returns a set with maximum size.
+    int removeMax();
+
+    // Returns the size of the given set. Sets keep their size when removed.
+    int sizeOf(int setId) const;
+
+    // Steates if the set is empty or not.
+    bool isEmpty() const;
+
+
+private:
+
+    // Index of a set in setList (-1 if removed) and its size.
+    struct SetInfo
+    {
+        int32_t idx;
+        int32_t size;
+    };
+
+    // Contains the stored sets in order of their size.
+    vector<int32_t> setList;
+
+    // States the index and size of each set.
+    vector<SetInfo> setInfo;
+
+    // The end indices (inclusive) of each group of equal size. For all sizes
+    // from topSize to topSize + 1, it is the index of the last set.
+    vector<int32_t> endIndices;
+
+    // The largest size of any stored set.
+    int32_t topSize = 0;
+
+
+    // Increases the size of the given (not removed) set by 1.
+    void increase(SetInfo& info);
+};
+
 #endif
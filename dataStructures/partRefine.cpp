@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 
@@ -16,6 +17,14 @@ PartRefinement::PartRefinement(size_t k)
     // Prevents an error in refine() when adding a new group can destroy references.
     groups.reserve(k);
 
+    // Scratch buffers. At most k groups and IDs can be involved in a refinement.
+    modGrps.reserve(k);
+    inFirst.reserve(k);
+    inLast.reserve(k);
+    batchIds.reserve(k);
+    batchPairs.reserve(k);
+    batchInfo.resize(k, sizePair(0, 0));
+
     // One group containing all.
     groups.push_back(Group());
     groups[0].end = k - 1;
@@ -39,9 +48,20 @@ PartRefinement::PartRefinement(size_t k)
 
 // Refines the current groups based on the given list of IDs.
 // Returns the indices of the newly created groups.
-vector<size_t> PartRefinement::refine(const vector<int>& idList)
+vector<size_t> PartRefinement::refine(const IdSpan& idList)
 {
-    vector<size_t> modifiedGrps;
+    vector<size_t> newGroups;
+    refine(idList, [&newGroups](size_t grpIdx) { newGroups.push_back(grpIdx); });
+
+    return newGroups;
+}
+
+// Refines the current groups based on the given list of IDs.
+// Calls onNewGroup (if set) with the index of each newly created group.
+// Does not allocate memory; all buffers are reused between calls.
+void PartRefinement::refine(const IdSpan& idList, const groupSink& onNewGroup)
+{
+    modGrps.clear();
 
     // --- Flag IDs and move them to the end of their respective groups. ---
 
@@ -62,16 +82,14 @@ vector<size_t> PartRefinement::refine(const vector<int>& idList)
         swap(ordIdx, endIdx);
 
         // If needed, add to list of modified groups (needed for splitting).
-        if (grp.count == 0) modifiedGrps.push_back(grpIdx);
+        if (grp.count == 0) modGrps.push_back(grpIdx);
         grp.count++;
     }
 
 
     // --- Split modified groups. ---
 
-    vector<size_t> newGroups;
-
-    for (const size_t& grpIdx : modifiedGrps)
+    for (const size_t& grpIdx : modGrps)
     {
         Group& grp = groups[grpIdx];
 
@@ -84,7 +102,6 @@ vector<size_t> PartRefinement::refine(const vector<int>& idList)
         }
 
         size_t newGrpIdx = groups.size();
-        newGroups.push_back(newGrpIdx);
 
         groups.push_back(Group());
         Group& newGrp = groups.back();
@@ -116,14 +133,230 @@ vector<size_t> PartRefinement::refine(const vector<int>& idList)
             int vId = order[i];
             id2Grp[vId] = newGrpIdx;
         }
+
+        if (onNewGroup) onNewGroup(newGrpIdx);
     }
+}
 
-    return newGroups;
+// Refines the current groups based on each of the given lists of IDs in
+// turn. Results in the same groups (in the same order) as calling refine()
+// for each list, but splits each group at most once and updates group
+// references only once per batch. Lists must not contain an ID twice.
+// Calls onNewGroup (if set) with the index of each newly created group.
+// Reuses its buffers between calls.
+void PartRefinement::refineBatch(const vector<IdSpan>& idLists, const groupSink& onNewGroup)
+{
+    // Refining with lists L_1, ..., L_b in turn splits each group G based on
+    // which lists contain an ID. Within G, IDs are ordered lexicographically
+    // by (x in L_1, x in L_2, ...) where "in" comes after "not in". Thus, IDs
+    // in no list stay at the front and each distinct combination of lists
+    // becomes its own group, in that order.
+    //
+    // We therefore collect, for each ID, the lists that contain it (one pass
+    // over all lists), move the marked IDs of each group to its end, sort them
+    // by their lists, and split each group once.
+
+
+    // --- Count lists per ID. ---
+
+    // IDs in singleton groups cannot be split off; they are skipped.
+    batchIds.clear();
+    batchPairs.clear();
+    modGrps.clear();
+
+    for (size_t lIdx = 0; lIdx < idLists.size(); lIdx++)
+    {
+        for (const int& id : idLists[lIdx])
+        {
+            size_t grpIdx = id2Grp[id];
+            if (grpIdx == -1) continue;
+
+            Group& grp = groups[grpIdx];
+            if (grp.start == grp.end) continue;
+
+            if (batchInfo[id].second == 0)
+            {
+                batchIds.push_back(id);
+
+                if (grp.count == 0) modGrps.push_back(grpIdx);
+                grp.count++;
+            }
+
+            batchInfo[id].second++;
+            batchPairs.push_back(intPair(id, lIdx));
+        }
+    }
+
+    // Nothing to do?
+    if (batchIds.empty()) return;
+
+
+    // --- Store lists per ID. ---
+
+    size_t total = 0;
+    for (const int& id : batchIds)
+    {
+        batchInfo[id].first = total;
+        total += batchInfo[id].second;
+        batchInfo[id].second = 0;
+    }
+
+    batchLists.resize(total);
+
+    // Pairs are ordered by list; hence, the lists of each ID are sorted.
+    for (const intPair& p : batchPairs)
+    {
+        int id = p.first;
+        batchLists[batchInfo[id].first + batchInfo[id].second] = p.second;
+        batchInfo[id].second++;
+    }
+
+
+    // --- Move marked IDs to the end of their group. ---
+
+    // grp.count counts the moved IDs; it ends at the number of marked IDs again.
+    // IDs are in order of their first list. Thus, afterwards, the marked IDs
+    // of each group are ordered by their first list, largest index first.
+    for (const size_t& grpIdx : modGrps)
+    {
+        groups[grpIdx].count = 0;
+    }
+
+    for (const int& id : batchIds)
+    {
+        Group& grp = groups[id2Grp[id]];
+        int endId = order[grp.end - grp.count];
+
+        size_t& ordIdx = id2Ord[id];
+        size_t& endIdx = id2Ord[endId];
+
+        swap(order[ordIdx], order[endIdx]);
+        swap(ordIdx, endIdx);
+
+        grp.count++;
+    }
+
+
+    // --- Sort marked IDs and split groups. ---
+
+    auto before = [this](const int& aId, const int& bId) { return batchBefore(aId, bId); };
+
+    for (const size_t& grpIdx : modGrps)
+    {
+        Group& grp = groups[grpIdx];
+
+        // Creating groups below may move grp; keep the relevant values.
+        size_t grpEnd = grp.end;
+        size_t first = grpEnd - grp.count + 1;
+        bool allMarked = grp.count == grpEnd - grp.start + 1;
+        grp.count = 0;
+
+        // The marked IDs are already ordered by their first list (see above).
+        // Only IDs with the same first list and further lists need sorting.
+        for (size_t runStart = first, runEnd; runStart <= grpEnd; runStart = runEnd + 1)
+        {
+            int firstList = batchLists[batchInfo[order[runStart]].first];
+            bool needsSort = batchInfo[order[runStart]].second > 1;
+
+            for (runEnd = runStart; runEnd < grpEnd; runEnd++)
+            {
+                int nextId = order[runEnd + 1];
+                if (batchLists[batchInfo[nextId].first] != firstList) break;
+                needsSort |= batchInfo[nextId].second > 1;
+            }
+
+            if (!needsSort || runStart == runEnd) continue;
+
+            sort(order.begin() + runStart, order.begin() + runEnd + 1, before);
+
+            for (size_t i = runStart; i <= runEnd; i++)
+            {
+                id2Ord[order[i]] = i;
+            }
+        }
+
+        // Split into runs of IDs in the same lists. If no ID of the group is
+        // unmarked, the group keeps the first run.
+        size_t curIdx = grpIdx;
+        size_t runStart = first;
+
+        if (allMarked)
+        {
+            while (runStart <= grpEnd && !batchBefore(order[first], order[runStart])) runStart++;
+        }
+
+        while (runStart <= grpEnd)
+        {
+            size_t runEnd = runStart;
+            while (runEnd < grpEnd && !batchBefore(order[runStart], order[runEnd + 1])) runEnd++;
+
+            size_t newGrpIdx = groups.size();
+
+            groups.push_back(Group());
+            Group& newGrp = groups.back();
+            Group& curGrp = groups[curIdx];
+
+            grpCount++;
+
+            newGrp.start = runStart;
+            newGrp.end = runEnd;
+            newGrp.prev = curIdx;
+            newGrp.next = curGrp.next;
+
+            curGrp.end = runStart - 1;
+            curGrp.next = newGrpIdx;
+
+            if (lGrpIdx == curIdx)
+            {
+                lGrpIdx = newGrpIdx;
+            }
+            else
+            {
+                groups[newGrp.next].prev = newGrpIdx;
+            }
+
+            // Update references for IDs in group.
+            for (size_t i = newGrp.start; i <= newGrp.end; i++)
+            {
+                id2Grp[order[i]] = newGrpIdx;
+            }
+
+            if (onNewGroup) onNewGroup(newGrpIdx);
+
+            curIdx = newGrpIdx;
+            runStart = runEnd + 1;
+        }
+    }
+
+
+    // --- Reset counters. ---
+
+    for (const int& id : batchIds) batchInfo[id].second = 0;
+}
+
+// Helper function for refineBatch().
+// Determines if the lists containing ID a are ordered before the ones of
+// ID b, i.e., if a ends up before b when refining with all lists in turn.
+bool PartRefinement::batchBefore(int aId, int bId) const
+{
+    const int* aLists = batchLists.data() + batchInfo[aId].first;
+    const int* bLists = batchLists.data() + batchInfo[bId].first;
+
+    size_t aCount = batchInfo[aId].second;
+    size_t bCount = batchInfo[bId].second;
+
+    for (size_t i = 0; i < aCount && i < bCount; i++)
+    {
+        // The first list that contains only one of them moves it behind the other.
+        if (aLists[i] != bLists[i]) return aLists[i] > bLists[i];
+    }
+
+    return aCount < bCount;
 }
 
 // Refines the the first and last group that contain any of the given IDs.
 // Refinement happens towards each other instead of towards the end.
-void PartRefinement::flRefine(const vector<int>& idList)
+void PartRefinement::flRefine(const IdSpan& idList)
 {
     // --- Find first and last group. ---
 
@@ -146,8 +379,8 @@ void PartRefinement::flRefine(const vector<int>& idList)
     size_t l_GrpIdx = id2Grp[id0];
 
     // IDs that are in the first or last group, respectively.
-    vector<int> inFirst;
-    vector<int> inLast;
+    inFirst.clear();
+    inLast.clear();
 
     for (; lstIdx < idList.size(); lstIdx++)
     {
@@ -380,7 +613,7 @@ bool PartRefinement::dropSingles()
     return size() > 0;
 }
 
-// Determines if the given ID is in a group with additional IDs.
+// Determines if the given ID is either dropped or allone in its group.
 bool PartRefinement::isDroppedOrSingle(int id) const
 {
     assert(id >= 0 && id < id2Grp.size());
@@ -391,3 +624,10 @@ bool PartRefinement::isDroppedOrSingle(int id) const
     const Group& grp = groups[grpIdx];
     return grp.start == grp.end;
 }
+
+// Returns the index of the group containing the given ID, or -1 if it is dropped.
+size_t PartRefinement::groupOf(int id) const
+{
+    assert(id >= 0 && id < id2Grp.size());
+    return id2Grp[id];
+}
@@ -5,8 +5,12 @@
 
 
 #include <cstdlib>
+#include <functional>
 #include <vector>
 
+#include "idSpan.h"
+#include "../helper.h"
+
 using namespace std;
 
 
@@ -14,6 +18,10 @@ class PartRefinement
 {
 public:
 
+    // Receives the index of a newly created group.
+    typedef function<void(size_t)> groupSink;
+
+
     // Default constructor.
     // Creates an empty data structure.
     PartRefinement();
@@ -25,11 +33,24 @@ public:
 
     // Refines the current groups based on the given list of IDs.
     // Returns the indices of the newly created groups.
-    vector<size_t> refine(const vector<int>& idList);
+    vector<size_t> refine(const IdSpan& idList);
+
+    // Refines the current groups based on the given list of IDs.
+    // Calls onNewGroup (if set) with the index of each newly created group.
+    // Does not allocate memory; all buffers are reused between calls.
+    void refine(const IdSpan& idList, const groupSink& onNewGroup);
+
+    // Refines the current groups based on each of the given lists of IDs in
+    // turn. Results in the same groups (in the same order) as calling refine()
+    // for each list, but splits each group at most once and updates group
+    // references only once per batch. Lists must not contain an ID twice.
+    // Calls onNewGroup (if set) with the index of each newly created group.
+    // Reuses its buffers between calls.
+    void refineBatch(const vector<IdSpan>& idLists, const groupSink& onNewGroup);
 
     // Refines the the first and last group that contain any of the given IDs.
     // Refinement happens towards each other instead of towards the end.
-    void flRefine(const vector<int>& idList);
+    void flRefine(const IdSpan& idList);
 
 
     // The current number of non-empty groups.
@@ -53,6 +74,9 @@ public:
     // Determines if the given ID is either dropped or allone in its group.
     bool isDroppedOrSingle(int id) const;
 
+    // Returns the index of the group containing the given ID, or -1 if it is dropped.
+    size_t groupOf(int id) const;
+
 
 protected:
 
@@ -92,6 +116,31 @@ protected:
 
     // States for each ID where it is in the order.
     vector<size_t> id2Ord;
+
+
+    // Buffers reused by refine() and flRefine().
+    // Each has capacity k so that adding elements never reallocates.
+
+    // The groups which contain IDs of the current list.
+    vector<size_t> modGrps;
+
+    // IDs that are in the first or last group, respectively.
+    vector<int> inFirst;
+    vector<int> inLast;
+
+    // Buffers reused by refineBatch().
+    // For each ID marked in the current batch, batchInfo stores the start and
+    // number of the lists containing it in batchLists.
+    vector<int> batchIds;
+    vector<intPair> batchPairs;
+    vector<sizePair> batchInfo;
+    vector<int> batchLists;
+
+
+    // Helper function for refineBatch().
+    // Determines if the lists containing ID a are ordered before the ones of
+    // ID b, i.e., if a ends up before b when refining with all lists in turn.
+    bool batchBefore(int aId, int bId) const;
 };
 
 #endif
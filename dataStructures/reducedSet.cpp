@@ -1,64 +1,155 @@
 #include <stdexcept>
 
+#if defined(__x86_64__) || defined(__i386__)
+#define __ReducedSet_X86__
+#include <immintrin.h>
+#endif
+
 #include "reducedSet.h"
 
 
+// The implementation currently used to compute intersections.
+ReducedSet::interKernel ReducedSet::intersect = ReducedSet::getKernel(ReducedSet::defaultKernel());
+
+
 // Copy constructor.
-ReducedSet::ReducedSet(const ReducedSet& set) :
-    n(set.n),
-    R(new wordIndex[set.n])
+ReducedSet::ReducedSet(const ReducedSet& set)
 {
-    copy(set.R, set.R + set.n, R);
+    allocate(set.n, set.dense);
+    n = set.n;
+    dense = set.dense;
+    first = set.first;
+
+    if (!dense) copy(set.I, set.I + storedWords(), I);
+    copy(set.W, set.W + storedWords(), W);
 }
 
 // Move constructor.
 ReducedSet::ReducedSet(ReducedSet&& set) :
     n(set.n),
-    R(set.R)
+    I(set.I),
+    W(set.W),
+    dense(set.dense),
+    first(set.first)
 {
     set.n = -1;
-    set.R = nullptr;
+    set.I = nullptr;
+    set.W = nullptr;
 }
 
 // Constructor.
 // Creates a set from a list of elements.
 // Assumes that the given list is sorted.
-ReducedSet::ReducedSet(const vector<int>& list)
+ReducedSet::ReducedSet(const IdSpan& list)
+{
+    build(list, -1, Format::Reduced);
+}
+
+// Constructor.
+// Creates a set from a list of elements while ignoring one of them.
+// Assumes that the given list is sorted.
+ReducedSet::ReducedSet(const IdSpan& list, int ignore)
+{
+    build(list, ignore, Format::Reduced);
+}
+
+// Constructor.
+// Creates a set from a list of elements using the given format.
+// Assumes that the given list is sorted.
+ReducedSet::ReducedSet(const IdSpan& list, Format format)
 {
-    vector<wordIndex> rBuilder;
+    build(list, -1, format);
+}
 
-    for (int i = 0, lastIdx = -1; i < list.size(); i++)
+
+// Destructor.
+ReducedSet::~ReducedSet()
+{
+    if (W != nullptr) delete[] W;
+}
+
+
+// Helper function for constructors.
+// Allocates memory for the given number of non-zero words and their indices.
+// Does not free previously allocated memory.
+// Dense sets do not need memory for indices.
+void ReducedSet::allocate(int size, bool dense)
+{
+    size = max(size, 0);
+
+    if (dense)
+    {
+        W = new word[size];
+        I = nullptr;
+        return;
+    }
+
+    // Words first, since they need the larger alignment.
+    // Two indices fit into one word.
+    W = new word[size + (size + 1) / 2];
+    I = reinterpret_cast<int*>(W + size);
+}
+
+// Helper function for constructors.
+// Fills the set with the given elements (except ignore).
+// Assumes that the given list is sorted.
+void ReducedSet::build(const IdSpan& list, int ignore, Format format)
+{
+    // Count non-zero words first. That way, we allocate memory only once.
+    int size = 0;
+    int firstIdx = -1;
+    int lastIdx = -1;
+
+    for (int i = 0; i < list.size(); i++)
     {
         int id = list[i];
+        if (id == ignore) continue;
 
         int wordIdx = id >> WordDiv;
-        int wordBit = id & WordMod;
 
         if (wordIdx > lastIdx)
         {
+            if (size == 0) firstIdx = wordIdx;
             lastIdx = wordIdx;
-            rBuilder.push_back(wordIndex(wordIdx, 0));
+            size++;
         }
+    }
 
-        word& lastWord = rBuilder.back().second;
-        lastWord |= (word)1 << wordBit;
+    int range = lastIdx - firstIdx + 1;
+
+    // Dense sets store all words in the range, reduced sets also store an
+    // index for each non-zero word.
+    if (format == Format::Auto)
+    {
+        bool smaller = (size_t)range * sizeof(word) <= (size_t)size * (sizeof(word) + sizeof(int));
+        format = (size > 0 && smaller) ? Format::Dense : Format::Reduced;
     }
 
+    if (format == Format::Dense && size > 0)
+    {
+        allocate(range, true);
+        n = range;
+        dense = true;
+        first = firstIdx;
 
-    // Store results.
-    n = rBuilder.size();
-    R = new wordIndex[n];
-    copy(rBuilder.begin(), rBuilder.end(), R);
-}
+        fill(W, W + n, 0);
 
-// Constructor.
-// Creates a set from a list of elements while ignoring one of them.
-// Assumes that the given list is sorted.
-ReducedSet::ReducedSet(const vector<int>& list, int ignore)
-{
-    vector<wordIndex> rBuilder;
+        for (int i = 0; i < list.size(); i++)
+        {
+            int id = list[i];
+            if (id == ignore) continue;
 
-    for (int i = 0, lastIdx = -1; i < list.size(); i++)
+            W[(id >> WordDiv) - first] |= (word)1 << (id & WordMod);
+        }
+
+        return;
+    }
+
+    allocate(size, false);
+    n = 0;
+    lastIdx = -1;
+
+    for (int i = 0; i < list.size(); i++)
     {
         int id = list[i];
         if (id == ignore) continue;
@@ -69,37 +160,30 @@ ReducedSet::ReducedSet(const vector<int>& list, int ignore)
         if (wordIdx > lastIdx)
         {
             lastIdx = wordIdx;
-            rBuilder.push_back(wordIndex(wordIdx, 0));
+
+            I[n] = wordIdx;
+            W[n] = 0;
+            n++;
         }
 
-        word& lastWord = rBuilder.back().second;
-        lastWord |= (word)1 << wordBit;
+        W[n - 1] |= (word)1 << wordBit;
     }
-
-
-    // Store results.
-    n = rBuilder.size();
-    R = new wordIndex[n];
-    copy(rBuilder.begin(), rBuilder.end(), R);
-}
-
-
-// Destructor.
-ReducedSet::~ReducedSet()
-{
-    if (R != nullptr) delete[] R;
 }
 
 
 // Copy assignment.
 ReducedSet& ReducedSet::operator=(const ReducedSet& set)
 {
-    if (R != nullptr) delete[] R;
+    if (this == &set) return *this;
+    if (W != nullptr) delete[] W;
 
+    allocate(set.n, set.dense);
     n = set.n;
-    R = new wordIndex[n];
+    dense = set.dense;
+    first = set.first;
 
-    copy(set.R, set.R + n, R);
+    if (!dense) copy(set.I, set.I + storedWords(), I);
+    copy(set.W, set.W + storedWords(), W);
 
     return *this;
 }
@@ -107,13 +191,17 @@ ReducedSet& ReducedSet::operator=(const ReducedSet& set)
 // Move assignment.
 ReducedSet& ReducedSet::operator=(ReducedSet&& set)
 {
-    if (R != nullptr) delete[] R;
+    if (W != nullptr) delete[] W;
 
     n = set.n;
-    R = set.R;
+    I = set.I;
+    W = set.W;
+    dense = set.dense;
+    first = set.first;
 
     set.n = -1;
-    set.R = nullptr;
+    set.I = nullptr;
+    set.W = nullptr;
 
     return *this;
 }
@@ -124,62 +212,161 @@ ReducedSet ReducedSet::operator&(const ReducedSet& rhs) const
 {
     const ReducedSet& lhs = (*this);
 
-    vector<wordIndex> rBuilder;
+    // The result is dense only if both sets are dense.
+    // Otherwise, we let the reduced set be the left side.
+    if (lhs.dense && !rhs.dense) return rhs & lhs;
 
-    // Compute intersection.
-    for (int l = 0, r = 0; l < lhs.n && r < rhs.n; )
+    ReducedSet result;
+
+    if (lhs.dense)
     {
-        int lIdx = lhs.R[l].first;
-        int rIdx = rhs.R[r].first;
+        result.allocate(min(lhs.n, rhs.n), true);
+        result.dense = true;
 
-        if (lIdx == rIdx)
-        {
-            word lWrd = lhs.R[l].second;
-            word rWrd = rhs.R[r].second;
+        result.n = intersectDense
+        (
+            lhs.W, lhs.first, lhs.n,
+            rhs.W, rhs.first, rhs.n,
+            result.W, result.first
+        );
 
-            word inter = lWrd & rWrd;
-            if (inter > 0)
-            {
-                rBuilder.push_back(wordIndex(lIdx, inter));
-            }
-        }
-
-        if (lIdx <= rIdx) l++;
-        if (lIdx >= rIdx) r++;
+        return result;
     }
 
+    // The intersection cannot be larger than the smaller set.
+    result.allocate(rhs.dense ? lhs.n : min(lhs.n, rhs.n), false);
 
+    result.n = intersectWith
+    (
+        lhs.I, lhs.W, lhs.n,
+        rhs,
+        result.I, result.W
+    );
 
-    // Store results.
-    int newN = rBuilder.size();
-    wordIndex* newR = new wordIndex[newN];
-    copy(rBuilder.begin(), rBuilder.end(), newR);
-
-    return ReducedSet(newN, newR);
+    return result;
 }
 
 // Changes the current set to be the intersection of the current and given set.
+// Allocates a new set if the current set is dense and the given one is not.
 void ReducedSet::operator&=(const ReducedSet& rhs)
 {
     ReducedSet& lhs = (*this);
 
+    if (lhs.dense && !rhs.dense)
+    {
+        // The result is reduced and does not fit into the memory of lhs.
+        lhs = rhs & lhs;
+        return;
+    }
+
+    // Update size.
+    if (lhs.dense)
+    {
+        lhs.n = intersectDense
+        (
+            lhs.W, lhs.first, lhs.n,
+            rhs.W, rhs.first, rhs.n,
+            lhs.W, lhs.first
+        );
+    }
+    else
+    {
+        lhs.n = intersectWith
+        (
+            lhs.I, lhs.W, lhs.n,
+            rhs,
+            lhs.I, lhs.W
+        );
+    }
+}
+
+// Creates an iterator pointing to the first element of the set.
+ReducedSet::Iterator ReducedSet::begin() const
+{
+    return Iterator::begin(*this);
+}
+
+// Creates an iterator pointing to the end of the set.
+const ReducedSet::Iterator ReducedSet::end() const
+{
+    return Iterator::end(*this);
+}
+
+
+
+// Determines if the CPU supports the given implementation.
+bool ReducedSet::isSupported(Kernel kernel)
+{
+    if (kernel == Kernel::Scalar) return true;
+
+#ifdef __ReducedSet_X86__
+    // Needed if called before constructors with higher priority.
+    __builtin_cpu_init();
+
+    if (kernel == Kernel::AVX2) return __builtin_cpu_supports("avx2");
+    if (kernel == Kernel::AVX512) return __builtin_cpu_supports("avx512f");
+#endif
+
+    return false;
+}
+
+// Determines the implementation used by default.
+ReducedSet::Kernel ReducedSet::defaultKernel()
+{
+    // The AVX-512 kernel is faster on dense sets, but slower on sparse sets
+    // (larger blocks overlap more often). The sets in Pritchard's algorithm
+    // are mostly sparse. Hence, we prefer AVX2.
+    if (isSupported(Kernel::AVX2)) return Kernel::AVX2;
+
+    return Kernel::Scalar;
+}
+
+// Selects the implementation used to compute intersections.
+// Returns false (and does not change the implementation) if the CPU does not support it.
+bool ReducedSet::useKernel(Kernel kernel)
+{
+    if (!isSupported(kernel)) return false;
+
+    intersect = getKernel(kernel);
+    return true;
+}
+
+// Returns the implementation of interKernel for the given kernel type.
+ReducedSet::interKernel ReducedSet::getKernel(Kernel kernel)
+{
+    switch (kernel)
+    {
+        case Kernel::AVX512: return intersectAvx512;
+        case Kernel::AVX2: return intersectAvx2;
+        default: return intersectScalar;
+    }
+}
+
+
+// --------------------------------
+// --- --- --- Kernels  --- --- ---
+
+
+// Computes the intersection of two arrays of non-zero words.
+// A set is given by its indices (lI, rI), words (lW, rW), and size (lN, rN).
+// Writes the result into oI[] and oW[] and returns its size.
+// The output may be the left set (i.e., oI == lI and oW == lW).
+int ReducedSet::intersectScalar(const int* lI, const word* lW, int lN, const int* rI, const word* rW, int rN, int* oI, word* oW)
+{
     int newN = 0;
 
-    // Compute intersection.
-    for (int l = 0, r = 0; l < lhs.n && r < rhs.n; )
+    for (int l = 0, r = 0; l < lN && r < rN; )
     {
-        int lIdx = lhs.R[l].first;
-        int rIdx = rhs.R[r].first;
+        int lIdx = lI[l];
+        int rIdx = rI[r];
 
         if (lIdx == rIdx)
         {
-            word lWrd = lhs.R[l].second;
-            word rWrd = rhs.R[r].second;
-
-            word inter = lWrd & rWrd;
+            word inter = lW[l] & rW[r];
             if (inter > 0)
             {
-                lhs.R[newN] = wordIndex(lIdx, inter);
+                oI[newN] = lIdx;
+                oW[newN] = inter;
                 newN++;
             }
         }
@@ -188,22 +375,255 @@ void ReducedSet::operator&=(const ReducedSet& rhs)
         if (lIdx >= rIdx) r++;
     }
 
-    // Update size.
-    lhs.n = newN;
+    return newN;
 }
 
-// Creates an iterator pointing to the first element of the set.
-ReducedSet::Iterator ReducedSet::begin() const
+
+// Computes the intersection of an array of non-zero words with a dense set.
+// The dense set is given by its words (rW), size (rN), and the index of
+// its first word (rFirst). Output is as for interKernel.
+int ReducedSet::intersectMixed(const int* lI, const word* lW, int lN, const word* rW, int rFirst, int rN, int* oI, word* oW)
 {
-    return Iterator::begin(*this);
+    // No search needed. Each word of the left set is looked up directly.
+    int newN = 0;
+
+    for (int l = 0; l < lN; l++)
+    {
+        int idx = lI[l] - rFirst;
+
+        // Out of range of the dense set. Indices are sorted.
+        if (idx < 0) continue;
+        if (idx >= rN) break;
+
+        word inter = lW[l] & rW[idx];
+
+        // Write unconditionally, only keep non-zero words.
+        // Safe if the output is the left set, since newN <= l.
+        oI[newN] = lI[l];
+        oW[newN] = inter;
+        newN += (inter != 0);
+    }
+
+    return newN;
 }
 
-// Creates an iterator pointing to the end of the set.
-const ReducedSet::Iterator ReducedSet::end() const
+// Computes the intersection of an array of non-zero words with any set.
+// Selects the kernel based on the format of the given set.
+int ReducedSet::intersectWith(const int* lI, const word* lW, int lN, const ReducedSet& rhs, int* oI, word* oW)
 {
-    return Iterator::end(*this);
+    if (rhs.dense)
+    {
+        return intersectMixed(lI, lW, lN, rhs.W, rhs.first, rhs.n, oI, oW);
+    }
+
+    return intersect(lI, lW, lN, rhs.I, rhs.W, rhs.n, oI, oW);
 }
 
+// Computes the intersection of two dense sets.
+// Writes the result into oW[] and its first index into oFirst.
+// Returns the size of the result. The output may be the left set.
+int ReducedSet::intersectDense(const word* lW, int lFirst, int lN, const word* rW, int rFirst, int rN, word* oW, int& oFirst)
+{
+    // Determine overlapping range.
+    int fr = max(lFirst, rFirst);
+    int to = min(lFirst + lN, rFirst + rN);
+
+    // Remove leading and trailing zero words.
+    // That way, the first and last word of a dense set are never zero.
+    while (fr < to && (lW[fr - lFirst] & rW[fr - rFirst]) == 0) fr++;
+    while (fr < to && (lW[to - 1 - lFirst] & rW[to - 1 - rFirst]) == 0) to--;
+
+    // Empty sets keep their first index.
+    if (fr >= to) return 0;
+
+    // Output starts at index fr. Since fr >= lFirst, writing into the left set
+    // never overwrites words which are not processed yet.
+    const word* lPtr = lW + (fr - lFirst);
+    const word* rPtr = rW + (fr - rFirst);
+    int size = to - fr;
+
+    for (int i = 0; i < size; i++)
+    {
+        oW[i] = lPtr[i] & rPtr[i];
+    }
+
+    oFirst = fr;
+    return size;
+}
+
+
+#ifdef __ReducedSet_X86__
+
+// The SIMD kernels below follow the scalar merge, but compare blocks of word
+// indices at once:
+//  - If the largest index of one block is smaller than the first index of the
+//    other block, the whole block contains no matches and is skipped.
+//  - If the blocks start with different indices, we skip all indices in the
+//    block which are smaller than the first index of the other block. Only
+//    indices are touched until a match is found.
+//  - If both blocks start with the same index, all lanes are compared at once
+//    and the longest run of equal indices is intersected in one go. Dense sets
+//    mostly consist of such runs. We branch on full runs (instead of always
+//    advancing by the run length) so that the CPU can predict the next block
+//    without waiting for the comparison.
+
+// Computes the intersection of two arrays of non-zero words using AVX2.
+// Compares blocks of 4 indices.
+__attribute__((target("avx2")))
+int ReducedSet::intersectAvx2(const int* lI, const word* lW, int lN, const int* rI, const word* rW, int rN, int* oI, word* oW)
+{
+    const __m256i zero = _mm256_setzero_si256();
+
+    int newN = 0;
+    int l = 0;
+    int r = 0;
+
+    while (l + 4 <= lN && r + 4 <= rN)
+    {
+        int lFirst = lI[l];
+        int rFirst = rI[r];
+
+        // Blocks do not overlap?
+        if (lI[l + 3] < rFirst) { l += 4; continue; }
+        if (rI[r + 3] < lFirst) { r += 4; continue; }
+
+        __m128i lVec = _mm_loadu_si128((const __m128i*)(lI + l));
+        __m128i rVec = _mm_loadu_si128((const __m128i*)(rI + r));
+
+        // Blocks not aligned?
+        // Skip all indices smaller than the first index of the other block.
+        // Skips at least one index since the first ones are not equal.
+        if (lFirst < rFirst)
+        {
+            __m128i smaller = _mm_cmpgt_epi32(_mm_set1_epi32(rFirst), lVec);
+            l += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(smaller)));
+            continue;
+        }
+        if (rFirst < lFirst)
+        {
+            __m128i smaller = _mm_cmpgt_epi32(_mm_set1_epi32(lFirst), rVec);
+            r += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(smaller)));
+            continue;
+        }
+
+        // Determine run of equal indices.
+        // The first lane is always equal.
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(lVec, rVec)));
+        int run = (mask == 0xF ? 4 : __builtin_ctz(~mask));
+
+        // Intersect all four words.
+        __m256i inter = _mm256_and_si256
+        (
+            _mm256_loadu_si256((const __m256i*)(lW + l)),
+            _mm256_loadu_si256((const __m256i*)(rW + r))
+        );
+
+        // Only keep non-zero words in the run.
+        int nonZero = ~_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(inter, zero)));
+        int keep = nonZero & ((1 << run) - 1);
+
+        alignas(32) word words[4];
+        _mm256_store_si256((__m256i*)words, inter);
+
+        // Note that the output may be the left set. Writing only within the run
+        // ensures that we never overwrite entries which are not processed yet.
+        for (int j = 0; j < run; j++)
+        {
+            oI[newN] = lI[l + j];
+            oW[newN] = words[j];
+            newN += (keep >> j) & 1;
+        }
+
+        l += run;
+        r += run;
+    }
+
+    // Process remaining entries.
+    return newN + intersectScalar(lI + l, lW + l, lN - l, rI + r, rW + r, rN - r, oI + newN, oW + newN);
+}
+
+// Computes the intersection of two arrays of non-zero words using AVX-512.
+// Compares blocks of 8 indices.
+__attribute__((target("avx512f")))
+int ReducedSet::intersectAvx512(const int* lI, const word* lW, int lN, const int* rI, const word* rW, int rN, int* oI, word* oW)
+{
+    int newN = 0;
+    int l = 0;
+    int r = 0;
+
+    while (l + 8 <= lN && r + 8 <= rN)
+    {
+        int lFirst = lI[l];
+        int rFirst = rI[r];
+
+        // Blocks do not overlap?
+        if (lI[l + 7] < rFirst) { l += 8; continue; }
+        if (rI[r + 7] < lFirst) { r += 8; continue; }
+
+        __m256i lVec = _mm256_loadu_si256((const __m256i*)(lI + l));
+        __m256i rVec = _mm256_loadu_si256((const __m256i*)(rI + r));
+
+        // Blocks not aligned?
+        // Skip all indices smaller than the first index of the other block.
+        // Skips at least one index since the first ones are not equal.
+        if (lFirst < rFirst)
+        {
+            __m256i smaller = _mm256_cmpgt_epi32(_mm256_set1_epi32(rFirst), lVec);
+            l += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(smaller)));
+            continue;
+        }
+        if (rFirst < lFirst)
+        {
+            __m256i smaller = _mm256_cmpgt_epi32(_mm256_set1_epi32(lFirst), rVec);
+            r += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(smaller)));
+            continue;
+        }
+
+        // Determine run of equal indices.
+        // The first lane is always equal.
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(lVec, rVec)));
+        int run = (mask == 0xFF ? 8 : __builtin_ctz(~mask));
+
+        // Intersect all eight words.
+        __m512i inter = _mm512_and_si512
+        (
+            _mm512_loadu_si512((const void*)(lW + l)),
+            _mm512_loadu_si512((const void*)(rW + r))
+        );
+
+        // Only keep non-zero words in the run.
+        __mmask8 keep = _mm512_test_epi64_mask(inter, inter) & ((1 << run) - 1);
+
+        // Note that the output may be the left set. Only kept entries are
+        // written, hence we never overwrite entries which are not processed yet.
+        _mm512_mask_compressstoreu_epi64(oW + newN, keep, inter);
+        _mm512_mask_compressstoreu_epi32(oI + newN, keep, _mm512_castsi256_si512(lVec));
+        newN += __builtin_popcount(keep);
+
+        l += run;
+        r += run;
+    }
+
+    // Process remaining entries.
+    return newN + intersectAvx2(lI + l, lW + l, lN - l, rI + r, rW + r, rN - r, oI + newN, oW + newN);
+}
+
+#else
+
+// Fallbacks for other architectures. Never supported.
+
+int ReducedSet::intersectAvx2(const int* lI, const word* lW, int lN, const int* rI, const word* rW, int rN, int* oI, word* oW)
+{
+    return intersectScalar(lI, lW, lN, rI, rW, rN, oI, oW);
+}
+
+int ReducedSet::intersectAvx512(const int* lI, const word* lW, int lN, const int* rI, const word* rW, int rN, int* oI, word* oW)
+{
+    return intersectScalar(lI, lW, lN, rI, rW, rN, oI, oW);
+}
+
+#endif
+
 
 
 // --------------------------------
@@ -212,8 +632,10 @@ const ReducedSet::Iterator ReducedSet::end() const
 
 // Copy constructor.
 ReducedSet::Iterator::Iterator(const Iterator& it) :
-    ptr(it.ptr),
+    idxPtr(it.idxPtr),
+    wrdPtr(it.wrdPtr),
     length(it.length),
+    wordIdx(it.wordIdx),
     bitIdx(it.bitIdx)
 {
     // Nothing to do.
@@ -222,8 +644,10 @@ ReducedSet::Iterator::Iterator(const Iterator& it) :
 // Copy assignment.
 ReducedSet::Iterator& ReducedSet::Iterator::operator=(const Iterator& rhs)
 {
-    ptr = rhs.ptr;
+    idxPtr = rhs.idxPtr;
+    wrdPtr = rhs.wrdPtr;
     length = rhs.length;
+    wordIdx = rhs.wordIdx;
     bitIdx = rhs.bitIdx;
     return *this;
 }
@@ -250,8 +674,9 @@ bool ReducedSet::Iterator::operator==(const Iterator& rhs) const
 {
     const Iterator& lhs = *this;
 
+    // Dense sets have no indices. Hence, compare words.
     return
-        lhs.ptr == rhs.ptr &&
+        lhs.wrdPtr == rhs.wrdPtr &&
         lhs.length == rhs.length &&
         lhs.bitIdx == rhs.bitIdx;
 }
@@ -266,8 +691,7 @@ bool ReducedSet::Iterator::operator!=(const Iterator& rhs) const
 // Dereference operator.
 int ReducedSet::Iterator::operator*() const
 {
-    int wIdx = ptr[0].first;
-    return (wIdx << WordDiv) | bitIdx;
+    return (wordIdx << WordDiv) | bitIdx;
 }
 
 
@@ -275,36 +699,40 @@ int ReducedSet::Iterator::operator*() const
 // Is equal to end if set is empty or invalid.
 ReducedSet::Iterator ReducedSet::Iterator::begin(const ReducedSet& set)
 {
-    Iterator it;
-    if (set.R == nullptr) return it;
+    return begin(set.dense ? nullptr : set.I, set.W, set.n, set.first);
+}
 
-    it.ptr = set.R;
-    it.length = set.n;
+// Creates an iterator that points to the end of a given set.
+const ReducedSet::Iterator ReducedSet::Iterator::end(const ReducedSet& set)
+{
+    return end(set.dense ? nullptr : set.I, set.W, set.n);
+}
 
-    if (it.length > 0)
-    {
-        word w = it.ptr[0].second;
 
-        if (w == 0)
-        {
-            throw logic_error("Invalid ReducedSet: contains all-zero entries.");
-        }
+// Creates an iterator that points to the beginning of a set given by its arrays.
+// For dense sets, I is nullptr and first is the index of the first word.
+ReducedSet::Iterator ReducedSet::Iterator::begin(const int* I, const word* W, int n, int first)
+{
+    Iterator it;
+    if (W == nullptr) return it;
 
-        // Find first non-zero bit.
-        // Number of trailing 0s (i.e., starting from LSB).
-        it.bitIdx = __builtin_ctzl(w);
-    }
+    it.idxPtr = I;
+    it.wrdPtr = W;
+    it.length = n;
+    it.wordIdx = first;
 
+    it.findWord();
     return it;
 }
 
-// Creates an iterator that points to the end of a given set.
-const ReducedSet::Iterator ReducedSet::Iterator::end(const ReducedSet& set)
+// Creates an iterator that points to the end of a set given by its arrays.
+const ReducedSet::Iterator ReducedSet::Iterator::end(const int* I, const word* W, int n)
 {
     Iterator it;
-    if (set.R == nullptr) return it;
+    if (W == nullptr) return it;
 
-    it.ptr = set.R + set.n;
+    it.idxPtr = (I == nullptr ? nullptr : I + n);
+    it.wrdPtr = W + n;
     it.length = 0;
 
     return it;
@@ -314,46 +742,238 @@ const ReducedSet::Iterator ReducedSet::Iterator::end(const ReducedSet& set)
 // Helper function that finds the next entry in the set.
 void ReducedSet::Iterator::findNext()
 {
-    if (ptr == nullptr || length <= 0)
+    if (wrdPtr == nullptr || length <= 0)
     {
         throw logic_error("Iterator already at end of ReducedSet.");
     }
 
     // Move at least one bit.
     bitIdx++;
-    word w = ptr[0].second >> bitIdx;
 
     // Check if still bits in word.
-    if (bitIdx < WordSize && w > 0)
+    if (bitIdx < WordSize)
     {
-        // Still bits in the current word.
-        // Shift to it, then done.
+        word w = wrdPtr[0] >> bitIdx;
 
-        // Number of trailing 0s (i.e., starting from LSB).
-        bitIdx += __builtin_ctzl(w);
-        return;
+        if (w > 0)
+        {
+            // Still bits in the current word.
+            // Shift to it, then done.
+
+            // Number of trailing 0s (i.e., starting from LSB).
+            bitIdx += __builtin_ctzl(w);
+            return;
+        }
     }
 
 
     // No more bits in current word.
     // Go to next word.
 
-    ptr++;
+    if (idxPtr != nullptr) idxPtr++;
+    wrdPtr++;
+    wordIdx++;
     length--;
+
+    findWord();
+}
+
+// Helper function that moves to the next non-zero word, starting with the current one.
+// Dense sets may contain zero words, reduced sets may not.
+void ReducedSet::Iterator::findWord()
+{
     bitIdx = 0;
 
-    // Reached end of sedt. Done.
-    if (length <= 0) return;
+    for (; length > 0; wrdPtr++, wordIdx++, length--)
+    {
+        word w = wrdPtr[0];
 
+        if (w != 0)
+        {
+            if (idxPtr != nullptr) wordIdx = idxPtr[0];
 
-    // Find first non-zero bit.
-    w = ptr[0].second;
+            // Determines number of trailing 0s (i.e., starting from LSB).
+            bitIdx = __builtin_ctzl(w);
+            return;
+        }
 
-    if (w == 0)
+        if (idxPtr != nullptr)
+        {
+            throw logic_error("Invalid ReducedSet: contains an all-zero entry.");
+        }
+    }
+
+    // Reached end of set. Done.
+}
+
+
+
+// --------------------------------
+// --- --- --- Stack    --- --- ---
+
+
+// Destructor.
+ReducedSet::Stack::~Stack()
+{
+    if (W != nullptr) delete[] W;
+}
+
+
+// Removes sets from the top until the stack contains the given number of sets.
+void ReducedSet::Stack::resize(size_t size)
+{
+    if (size > count)
+    {
+        throw out_of_range("Cannot add sets by resizing a stack.");
+    }
+
+    // Only rewind. The buffer is reused by the next sets.
+    count = size;
+}
+
+
+// Adds a copy of the given set to the top of the stack.
+// Dense sets are converted into reduced sets.
+void ReducedSet::Stack::push(const ReducedSet& set)
+{
+    int n = set.storedWords();
+    reserve(n);
+
+    size_t start = top();
+
+    if (set.dense)
+    {
+        // Only keep non-zero words.
+        int size = 0;
+
+        for (int i = 0; i < n; i++)
+        {
+            I[start + size] = set.first + i;
+            W[start + size] = set.W[i];
+            size += (set.W[i] != 0);
+        }
+
+        n = size;
+    }
+    else
+    {
+        copy(set.I, set.I + n, I + start);
+        copy(set.W, set.W + n, W + start);
+    }
+
+    if (count >= starts.size())
+    {
+        starts.push_back(start);
+        sizes.push_back(n);
+    }
+    else
+    {
+        starts[count] = start;
+        sizes[count] = n;
+    }
+
+    count++;
+}
+
+// Adds the intersection of the top set and the given set to the top of the stack.
+void ReducedSet::Stack::pushIntersection(const ReducedSet& set)
+{
+    if (count == 0)
+    {
+        throw out_of_range("Stack is empty.");
+    }
+
+    // The intersection cannot be larger than the current top set.
+    reserve(sizes[count - 1]);
+
+    size_t prev = starts[count - 1];
+    size_t start = top();
+
+    int n = intersectWith
+    (
+        I + prev, W + prev, sizes[count - 1],
+        set,
+        I + start, W + start
+    );
+
+    if (count >= starts.size())
+    {
+        starts.push_back(start);
+        sizes.push_back(n);
+    }
+    else
     {
-        throw logic_error("Invalid ReducedSet: contains an all-zero entry.");
+        starts[count] = start;
+        sizes[count] = n;
     }
 
-    // Determines number of trailing 0s (i.e., starting from LSB).
-    bitIdx = __builtin_ctzl(w);
+    count++;
+}
+
+// Changes the top set to be the intersection of itself and the given set.
+void ReducedSet::Stack::intersectTop(const ReducedSet& set)
+{
+    if (count == 0)
+    {
+        throw out_of_range("Stack is empty.");
+    }
+
+    size_t start = starts[count - 1];
+
+    sizes[count - 1] = intersectWith
+    (
+        I + start, W + start, sizes[count - 1],
+        set,
+        I + start, W + start
+    );
+}
+
+
+// Creates an iterator pointing to the first element of the top set.
+ReducedSet::Iterator ReducedSet::Stack::begin() const
+{
+    if (count == 0) return Iterator();
+
+    size_t start = starts[count - 1];
+    return Iterator::begin(I + start, W + start, sizes[count - 1], 0);
+}
+
+// Creates an iterator pointing to the end of the top set.
+const ReducedSet::Iterator ReducedSet::Stack::end() const
+{
+    if (count == 0) return Iterator();
+
+    size_t start = starts[count - 1];
+    return Iterator::end(I + start, W + start, sizes[count - 1]);
+}
+
+
+// Ensures that the buffer can store the given number of additional entries.
+void ReducedSet::Stack::reserve(size_t size)
+{
+    size_t start = top();
+    if (start + size <= capacity) return;
+
+    // Grow geometrically to keep the number of allocations logarithmic.
+    size_t newCap = max(2 * capacity, start + size);
+
+    // Same layout as in ReducedSet::allocate().
+    word* newW = new word[newCap + (newCap + 1) / 2];
+    int* newI = reinterpret_cast<int*>(newW + newCap);
+
+    copy(I, I + start, newI);
+    copy(W, W + start, newW);
+
+    if (W != nullptr) delete[] W;
+
+    I = newI;
+    W = newW;
+    capacity = newCap;
+}
+
+// Determines where the next set starts in the buffer.
+size_t ReducedSet::Stack::top() const
+{
+    if (count == 0) return 0;
+    return starts[count - 1] + sizes[count - 1];
 }
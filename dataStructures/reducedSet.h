@@ -3,10 +3,13 @@
 #ifndef __ReducedSet_H__
 #define __ReducedSet_H__
 
+#include <algorithm>
 #include <iterator>
 #include <utility>
 #include <vector>
 
+#include "idSpan.h"
+
 using namespace std;
 
 
@@ -34,11 +37,30 @@ class ReducedSet
     static const unsigned int WordMod = WordSize - 1;
 
 
-    // Allows to manage non-zero words and their indices.
-    typedef pair<int, word> wordIndex;
+public:
 
+    // Implementations to compute intersections.
+    // The SIMD implementations are only available if the CPU supports them.
+    enum class Kernel
+    {
+        Scalar,
+        AVX2,
+        AVX512
+    };
+
+    // Ways to store a set.
+    //   Reduced: Only non-zero words and their indices (see Pritchard).
+    //   Dense:   All words between the first and last non-zero word.
+    //   Auto:    Dense if that does not need more memory than Reduced.
+    // Sets with many elements (e.g., vertices in most hyperedges) have few
+    // zero words. Storing them dense avoids storing and comparing indices.
+    enum class Format
+    {
+        Reduced,
+        Dense,
+        Auto
+    };
 
-public:
 
     // Default constructor.
     // Creates an invalid set.
@@ -53,12 +75,17 @@ public:
     // Constructor.
     // Creates a set from a list of elements.
     // Assumes that the given list is sorted.
-    ReducedSet(const vector<int>& list);
+    ReducedSet(const IdSpan& list);
 
     // Constructor.
     // Creates a set from a list of elements while ignoring one of them.
     // Assumes that the given list is sorted.
-    ReducedSet(const vector<int>& list, int ignore);
+    ReducedSet(const IdSpan& list, int ignore);
+
+    // Constructor.
+    // Creates a set from a list of elements using the given format.
+    // Assumes that the given list is sorted.
+    ReducedSet(const IdSpan& list, Format format);
 
     // Destructor.
     ~ReducedSet();
@@ -75,9 +102,17 @@ public:
     ReducedSet operator&(const ReducedSet& rhs) const;
 
     // Changes the current set to be the intersection of the current and given set.
+    // Allocates a new set if the current set is dense and the given one is not.
     void operator&=(const ReducedSet& rhs);
 
 
+    // Determines if the set is stored dense.
+    bool isDense() const { return dense; }
+
+    // The number of words stored.
+    int storedWords() const { return max(n, 0); }
+
+
     // Allows to iterate over all elements stored in the set.
     class Iterator;
 
@@ -88,18 +123,89 @@ public:
     const Iterator end() const;
 
 
+    // Stores a stack of sets in one reusable buffer.
+    class Stack;
+
+
+    // Determines if the CPU supports the given implementation.
+    static bool isSupported(Kernel kernel);
+
+    // Determines the implementation used by default.
+    static Kernel defaultKernel();
+
+    // Selects the implementation used to compute intersections.
+    // Returns false (and does not change the implementation) if the CPU does not support it.
+    static bool useKernel(Kernel kernel);
+
+
 private:
 
-    // Constructor.
-    // Creates a set of the given size that uses the given array.
-    ReducedSet(int size, wordIndex* arr) : n(size), R(arr) { }
+    // Computes the intersection of two arrays of non-zero words.
+    // A set is given by its indices (lI, rI), words (lW, rW), and size (lN, rN).
+    // Writes the result into oI[] and oW[] and returns its size.
+    // The output may be the left set (i.e., oI == lI and oW == lW).
+    typedef int (*interKernel)
+    (
+        const int* lI, const word* lW, int lN,
+        const int* rI, const word* rW, int rN,
+        int* oI, word* oW
+    );
+
+    // Implementations of interKernel.
+    static int intersectScalar(const int* lI, const word* lW, int lN, const int* rI, const word* rW, int rN, int* oI, word* oW);
+    static int intersectAvx2(const int* lI, const word* lW, int lN, const int* rI, const word* rW, int rN, int* oI, word* oW);
+    static int intersectAvx512(const int* lI, const word* lW, int lN, const int* rI, const word* rW, int rN, int* oI, word* oW);
+
+    // Computes the intersection of an array of non-zero words with a dense set.
+    // The dense set is given by its words (rW), size (rN), and the index of
+    // its first word (rFirst). Output is as for interKernel.
+    static int intersectMixed(const int* lI, const word* lW, int lN, const word* rW, int rFirst, int rN, int* oI, word* oW);
+
+    // Computes the intersection of an array of non-zero words with any set.
+    // Selects the kernel based on the format of the given set.
+    static int intersectWith(const int* lI, const word* lW, int lN, const ReducedSet& rhs, int* oI, word* oW);
+
+    // Computes the intersection of two dense sets.
+    // Writes the result into oW[] and its first index into oFirst.
+    // Returns the size of the result. The output may be the left set.
+    static int intersectDense(const word* lW, int lFirst, int lN, const word* rW, int rFirst, int rN, word* oW, int& oFirst);
+
+    // Returns the implementation of interKernel for the given kernel type.
+    static interKernel getKernel(Kernel kernel);
+
+    // The implementation currently used to compute intersections.
+    static interKernel intersect;
+
+    // Helper function for constructors.
+    // Allocates memory for the given number of non-zero words and their indices.
+    // Does not free previously allocated memory.
+    // Dense sets do not need memory for indices.
+    void allocate(int size, bool dense);
+
+    // Helper function for constructors.
+    // Fills the set with the given elements (except ignore).
+    // Assumes that the given list is sorted.
+    void build(const IdSpan& list, int ignore, Format format);
 
 
     // The number of nonzero words in the original array A.
     int n = -1;
 
-    // The non-zero words in array A and their respective indices in A.
-    wordIndex* R = nullptr;
+    // Indices and words are stored as separate arrays (structure of arrays).
+    // Searching for matching indices then only touches the indices, and an
+    // entry takes 12 instead of 16 bytes (a pair<int, word> is padded).
+
+    // The indices of the non-zero words in array A.
+    int* I = nullptr;
+
+    // The non-zero words in array A (in the same order as their indices).
+    // Both arrays share one allocation, which is owned by W.
+    word* W = nullptr;
+
+    // Dense sets store all words between the first and last non-zero word.
+    // They do not use I[]; W[i] is the word with index first + i.
+    bool dense = false;
+    int first = 0;
 };
 
 
@@ -156,19 +262,112 @@ public:
 
 private:
 
+    // Allows stacks to iterate over their sets.
+    friend class Stack;
+
+    // Creates an iterator that points to the beginning of a set given by its arrays.
+    // For dense sets, I is nullptr and first is the index of the first word.
+    static Iterator begin(const int* I, const word* W, int n, int first);
+
+    // Creates an iterator that points to the end of a set given by its arrays.
+    static const Iterator end(const int* I, const word* W, int n);
+
+
     // Helper function that finds the next entry in the set.
     void findNext();
 
+    // Helper function that moves to the next non-zero word, starting with the current one.
+    // Dense sets may contain zero words, reduced sets may not.
+    void findWord();
+
 
-    // Points to the array with data.
-    wordIndex* ptr = nullptr;
+    // Points to the arrays with data.
+    // idxPtr is nullptr for dense sets.
+    const int* idxPtr = nullptr;
+    const word* wrdPtr = nullptr;
 
     // Remaining amount of data.
     // Allows to determine when end is reached.
     int length = -1;
 
+    // The index of the current word.
+    int wordIdx = 0;
+
     // The index of the current bit in the word.
     int bitIdx = 0;
 };
 
+
+// Stores a stack of sets in one reusable buffer (an arena).
+class ReducedSet::Stack
+{
+    // Intended for algorithms that compute intersections of growing prefixes
+    // (e.g., Pritchard's algorithm). Sets are pushed on top of each other and
+    // removing sets only rewinds the buffer. Hence, once the buffer is large
+    // enough, no further heap allocations are needed.
+
+public:
+
+    // Default constructor.
+    // Creates an empty stack.
+    Stack() { }
+
+    // Destructor.
+    ~Stack();
+
+    // Stacks cannot be copied.
+    Stack(const Stack&) = delete;
+    Stack& operator=(const Stack&) = delete;
+
+
+    // The number of sets in the stack.
+    size_t size() const { return count; }
+
+    // Removes sets from the top until the stack contains the given number of sets.
+    void resize(size_t size);
+
+
+    // Adds a copy of the given set to the top of the stack.
+    // Dense sets are converted into reduced sets.
+    void push(const ReducedSet& set);
+
+    // Adds the intersection of the top set and the given set to the top of the stack.
+    void pushIntersection(const ReducedSet& set);
+
+    // Changes the top set to be the intersection of itself and the given set.
+    void intersectTop(const ReducedSet& set);
+
+
+    // Creates an iterator pointing to the first element of the top set.
+    Iterator begin() const;
+
+    // Creates an iterator pointing to the end of the top set.
+    const Iterator end() const;
+
+
+private:
+
+    // Ensures that the buffer can store the given number of additional entries.
+    void reserve(size_t size);
+
+    // Determines where the next set starts in the buffer.
+    size_t top() const;
+
+
+    // The buffer for all sets (same layout as in ReducedSet).
+    int* I = nullptr;
+    word* W = nullptr;
+
+    // The number of entries that fit into the buffer.
+    size_t capacity = 0;
+
+    // The number of sets in the stack.
+    size_t count = 0;
+
+    // The start and size of each set in the buffer.
+    // Never shrink, so that removing and adding sets does not allocate.
+    vector<size_t> starts;
+    vector<int> sizes;
+};
+
 #endif
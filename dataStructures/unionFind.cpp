@@ -1,3 +1,6 @@
+#include <cassert>
+#include <limits>
+
 #include "unionFind.h"
 
 
@@ -9,20 +12,20 @@ UnionFind::UnionFind() { /* Does nothing. */ }
 // Creates an empty data structure.
 UnionFind::UnionFind(size_t size) : size(size)
 {
-    parent = new size_t[size];
-    rank = new size_t[size];
+    // Parents and negated sizes are stored as 32-bit integers.
+    assert(size <= std::numeric_limits<int32_t>::max());
+
+    parent = new int32_t[size];
 
     for (size_t i = 0; i < size; i++)
     {
-        parent[i] = i;
-        rank[i] = 0;
+        parent[i] = -1;
     }
 }
 
 // Destructor.
 UnionFind::~UnionFind()
 {
-    if (rank != nullptr) delete[] rank;
     if (parent != nullptr) delete[] parent;
 }
 
@@ -35,28 +38,56 @@ void UnionFind::unionSets(size_t x, size_t y)
 
 
     // x and y are in different sets. Merge them.
+    // Sizes are negated; the smaller set is the one with larger value.
 
-    if (rank[xRoot] < rank[yRoot])
+    if (parent[xRoot] > parent[yRoot])
     {
-        parent[xRoot] = yRoot;
+        size_t tmp = xRoot;
+        xRoot = yRoot;
+        yRoot = tmp;
     }
-    else if (rank[xRoot] > rank[yRoot])
-    {
-        parent[yRoot] = xRoot;
-    }
-    else
+
+    parent[xRoot] += parent[yRoot];
+    parent[yRoot] = xRoot;
+}
+
+size_t UnionFind::findSet(size_t x)
+{
+    // Path halving: each visited element skips its parent.
+    while (true)
     {
-        parent[yRoot] = xRoot;
-        rank[xRoot]++;
+        int32_t p = parent[x];
+        if (p < 0) return x;
+
+        int32_t gp = parent[p];
+        if (gp < 0) return p;
+
+        parent[x] = gp;
+        x = gp;
     }
 }
 
-size_t UnionFind::findSet(size_t x)
+void UnionFind::findSets(const int* xs, int* roots, size_t count)
 {
-    if (parent[x] != x)
+    // Number of elements to look ahead.
+    const size_t dist = 16;
+
+    for (size_t i = 0; i < count && i < dist; i++)
     {
-        parent[x] = findSet(parent[x]);
+        __builtin_prefetch(parent + xs[i]);
     }
 
-    return parent[x];
+    for (size_t i = 0; i < count; i++)
+    {
+        if (i + dist < count)
+        {
+            __builtin_prefetch(parent + xs[i + dist]);
+        }
+
+        // Most trees are flat. Hence, the parent is often the root.
+        int32_t p = parent[xs[i]];
+        if (p >= 0) __builtin_prefetch(parent + p);
+
+        roots[i] = findSet(xs[i]);
+    }
 }
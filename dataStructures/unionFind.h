@@ -5,10 +5,16 @@
 
 
 #include <cstddef>
+#include <cstdint>
 
 
 class UnionFind
 {
+    // All information is stored in a single array.
+    // For a root x, parent[x] is the negated size of its set.
+    // For all other elements x, parent[x] is the parent of x.
+    // Find-operations use path halving and unions are by size.
+
 public:
 
     // Default constructor.
@@ -29,17 +35,19 @@ public:
     // Implements Find-operation.
     size_t findSet(size_t x);
 
+    // Implements Find-operation for count elements at once.
+    // Stores the root of xs[i] in roots[i]. Prefetches the parents of
+    // upcoming elements to hide memory latency.
+    void findSets(const int* xs, int* roots, size_t count);
+
 
 private:
 
     // Number of elements in data structure.
     size_t size = 0;
 
-    // Stores the rank of each element.
-    size_t* rank = nullptr;
-
-    // Stores the parent of each element.
-    size_t* parent = nullptr;
+    // Stores the parent of each element, or the negated set size for roots.
+    int32_t* parent = nullptr;
 };
 
 #endif
@@ -1,6 +1,8 @@
 
+#include <atomic>
 #include <iomanip>
 #include <iostream>
+#include <thread>
 
 #include "algorithms/sorting.h"
 #include "helper.h"
@@ -76,3 +78,69 @@ void printTime(int64_t time, ostream& out)
     }
     out << flush;
 }
+
+
+namespace
+{
+    // The number of threads set by setThreadCount() (0 if not set).
+    size_t fixedThreads = 0;
+}
+
+// The number of threads used by parallel algorithms.
+size_t threadCount()
+{
+    if (fixedThreads > 0) return fixedThreads;
+
+    // hardware_concurrency() returns 0 if the value is not computable.
+    static const size_t count = max(thread::hardware_concurrency(), 1u);
+    return count;
+}
+
+// Sets the number of threads used by parallel algorithms.
+// 0 restores the default (the number of hardware threads).
+void setThreadCount(size_t count)
+{
+    fixedThreads = count;
+}
+
+// Splits the range [0, size) into blocks of the given size and processes them with multiple threads.
+// Calls func(tId, fr, to) for each block [fr, to), where tId in [0, threadCount()) identifies the calling thread.
+void parallelFor(size_t size, size_t blockSize, const function<void(size_t, size_t, size_t)>& func)
+{
+    blockSize = max(blockSize, (size_t)1);
+
+    const size_t blocks = (size + blockSize - 1) / blockSize;
+    const size_t threads = min(threadCount(), blocks);
+
+    // Not worth starting threads.
+    if (threads <= 1)
+    {
+        if (size > 0) func(0, 0, size);
+        return;
+    }
+
+    // Blocks are assigned dynamically. That way, threads which process cheap
+    // blocks do not idle while others still work.
+    atomic<size_t> nextBlock(0);
+
+    auto worker = [&](size_t tId)
+    {
+        for (size_t b = nextBlock++; b < blocks; b = nextBlock++)
+        {
+            size_t fr = b * blockSize;
+            size_t to = min(fr + blockSize, size);
+            func(tId, fr, to);
+        }
+    };
+
+    vector<thread> pool;
+    for (size_t tId = 1; tId < threads; tId++)
+    {
+        pool.push_back(thread(worker, tId));
+    }
+
+    // Main thread helps as well.
+    worker(0);
+
+    for (thread& t : pool) t.join();
+}
@@ -3,6 +3,7 @@
 #ifndef __Helper_H__
 #define __Helper_H__
 
+#include <functional>
 #include <limits>
 #include <ostream>
 #include <utility>
@@ -35,4 +36,16 @@ void print(const vector<intPair>& pairs);
 // Prints the given time (in milliseconds) into the given stream using appropriate unit.
 void printTime(int64_t time, ostream& out);
 
+
+// The number of threads used by parallel algorithms.
+size_t threadCount();
+
+// Sets the number of threads used by parallel algorithms.
+// 0 restores the default (the number of hardware threads).
+void setThreadCount(size_t count);
+
+// Splits the range [0, size) into blocks of the given size and processes them with multiple threads.
+// Calls func(tId, fr, to) for each block [fr, to), where tId in [0, threadCount()) identifies the calling thread.
+void parallelFor(size_t size, size_t blockSize, const function<void(size_t, size_t, size_t)>& func);
+
 #endif
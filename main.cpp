@@ -5,6 +5,7 @@
 #include "algorithms/sorting.h"
 #include "dataStructures/hypergraph.h"
 #include "helper.h"
+#include "testing/testing.h"
 
 using namespace std;
 
@@ -31,7 +32,46 @@ Hypergraph randomHG(int n, int m, int N)
 }
 
 
+// Runs all tests. Returns true if all of them passed.
+bool runTests()
+{
+    using namespace Testing::UnionJoinTest;
+
+    bool passed = true;
+
+    passed &= Testing::testGeneralSSG(SubsetGraph::pritchardSimple, 1, 200, 200);
+    passed &= Testing::testGeneralSSG(SubsetGraph::pritchardReduced, 1, 200, 200);
+    passed &= Testing::testGeneralSSG(SubsetGraph::pritchardRefinement, 1, 200, 200);
+    passed &= Testing::unionJoinGraph(ujgLeitertPritchardSpeedUp, ujgLeitertPritchard, 1, 200, 200);
+    passed &= Testing::unionJoinGraph(ujgLineKruskal, ujgLeitertPritchard, 1, 200, 200);
+    passed &= Testing::parallelSSG(1, 20, 1000);
+    passed &= Testing::reducedSetKernels(1, 500, 200);
+    passed &= Testing::reducedSetStack(1, 200, 1000);
+    passed &= Testing::pritchardAllocations(1, 50, 1000);
+    passed &= Testing::hypergraphFiles(1, 200, 100);
+    passed &= Testing::hypergraphText(1, 200, 100);
+    passed &= Testing::unionJoinGraph(ujgLeitertLowMemory, ujgLeitertPritchard, 1, 200, 200);
+    passed &= Testing::unionJoinCsr(1, 200, 200);
+    passed &= Testing::incrementalUnionJoin(1, 200, 60);
+    passed &= Testing::linegraphEngines(1, 200, 100);
+    passed &= Testing::unionJoinGraph(ujgLineCheckAll, ujgLineKruskal, 1, 200, 200);
+    passed &= Testing::unionJoinGraph(ujgLineBottleneck, ujgLineKruskal, 1, 200, 200);
+    passed &= Testing::intervalSubsetGraph(1, 200, 200);
+    passed &= Testing::batchRefinement(1, 500, 200);
+    passed &= Testing::maxCardinalitySets(1, 1000, 200);
+
+    cout << endl << (passed ? "All test suites passed." : "Some test suites failed.") << endl;
+    return passed;
+}
+
+
 int main(int argc, char* argv[])
 {
     cout << "*** Union Join and Subset Graph of Acyclic Hypergraphs ***" << endl;
+
+    // Runs all tests with "test" (see target "test" in the makefile).
+    if (argc > 1 && string(argv[1]) == "test")
+    {
+        return runTests() ? 0 : 1;
+    }
 }
@@ -0,0 +1,73 @@
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "allocationCounter.h"
+
+using namespace std;
+
+
+#ifdef COUNT_ALLOCATIONS
+
+// Anonymous namespace for the counter.
+namespace
+{
+    // The number of allocations so far.
+    // Relaxed ordering suffices, we only need the total.
+    atomic<size_t> allocations(0);
+
+    // Allocates memory and counts the allocation.
+    void* countedAlloc(size_t size)
+    {
+        allocations.fetch_add(1, memory_order_relaxed);
+
+        void* ptr = malloc(size > 0 ? size : 1);
+        if (ptr == nullptr) throw bad_alloc();
+
+        return ptr;
+    }
+}
+
+
+// Replacements of the global allocation functions.
+// The array versions and the nothrow versions forward to these by default.
+
+void* operator new(size_t size)
+{
+    return countedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+
+#endif
+
+
+// The number of calls of (global) operator new since the program started.
+// Always 0 if allocations are not counted.
+size_t Testing::allocationCount()
+{
+#ifdef COUNT_ALLOCATIONS
+    return allocations.load(memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
+// Determines if allocations are counted, i.e., if COUNT_ALLOCATIONS is defined.
+bool Testing::countsAllocations()
+{
+#ifdef COUNT_ALLOCATIONS
+    return true;
+#else
+    return false;
+#endif
+}
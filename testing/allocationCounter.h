@@ -0,0 +1,24 @@
+// Counts heap allocations of the program.
+// Allows tests to verify that code does not allocate memory.
+// Replacing the global operator new costs an atomic increment per allocation.
+// Hence, allocations are only counted in builds that define COUNT_ALLOCATIONS
+// (see target "test" in the makefile).
+
+#ifndef __Testing_AllocationCounter_H__
+#define __Testing_AllocationCounter_H__
+
+
+#include <cstddef>
+
+
+namespace Testing
+{
+    // The number of calls of (global) operator new since the program started.
+    // Always 0 if allocations are not counted.
+    size_t allocationCount();
+
+    // Determines if allocations are counted, i.e., if COUNT_ALLOCATIONS is defined.
+    bool countsAllocations();
+}
+
+#endif
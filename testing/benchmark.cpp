@@ -0,0 +1,851 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include "../algorithms/alphaAcyclic.h"
+#include "../algorithms/interval.h"
+#include "../algorithms/sorting.h"
+#include "../algorithms/subsetGraph.h"
+#include "../dataStructures/incrementalUnionJoin.h"
+#include "../dataStructures/maxCardinalitySet.h"
+#include "../dataStructures/partRefine.h"
+#include "../dataStructures/reducedSet.h"
+#include "../helper.h"
+#include "allocationCounter.h"
+#include "benchmark.h"
+
+using namespace std;
+using namespace std::chrono;
+
+
+// See https://stackoverflow.com/a/11376759.
+#ifndef __Log_Ceil__
+#define LogC(X) ((unsigned) ((sizeof(unsigned long long) << 3) - __builtin_clzll((X) - 1)))
+#endif
+
+
+// Anonymous namespace for helper functions.
+namespace
+{
+    // Determines the number of microseconds since a given point in time.
+    // Individual test cases are often too fast to measure them in milliseconds.
+    int64_t usSince(const high_resolution_clock::time_point& start)
+    {
+        auto end = high_resolution_clock::now();
+        return duration_cast<microseconds>(end - start).count();
+    }
+
+    // Prints a single line of a benchmark table.
+    // The given time is in microseconds.
+    void printRow(const string& name, int64_t time)
+    {
+        cout << "  " << name << ": ";
+        printTime(time / 1000, cout);
+        cout << endl;
+    }
+
+
+    // Represents a hypergraph the way it was stored before switching to CSR.
+    // Each set is stored in its own vector.
+    typedef pair<vector<vector<int>>, vector<vector<int>>> vecHypergraph;
+
+    // Builds the vector-based representation from a sorted list of pairs.
+    vecHypergraph buildVecHypergraph(const vector<intPair>& list)
+    {
+        vecHypergraph result;
+        vector<vector<int>>& eSet = result.first;
+        vector<vector<int>>& vSet = result.second;
+
+        eSet.resize(list.back().first + 1);
+
+        for (size_t i = 0; i < list.size(); i++)
+        {
+            int eId = list[i].first;
+            int vId = list[i].second;
+
+            if (vSet.size() <= vId) vSet.resize(vId + 1);
+
+            eSet[eId].push_back(vId);
+            vSet[vId].push_back(eId);
+        }
+
+        return result;
+    }
+
+    // Visits, for each hyperedge, all hyperedges that share a vertex with it.
+    // Returns a checksum to ensure the traversal is not optimised away.
+    size_t twoHops(const vecHypergraph& hg)
+    {
+        size_t sum = 0;
+
+        for (const vector<int>& vList : hg.first)
+        {
+            for (const int& vId : vList)
+            {
+                for (const int& eId : hg.second[vId])
+                {
+                    sum += eId;
+                }
+            }
+        }
+
+        return sum;
+    }
+
+    // Visits, for each hyperedge, all hyperedges that share a vertex with it.
+    // Returns a checksum to ensure the traversal is not optimised away.
+    size_t twoHops(const Hypergraph& hg)
+    {
+        size_t sum = 0;
+
+        for (int eId = 0; eId < hg.getESize(); eId++)
+        {
+            for (const int& vId : hg[eId])
+            {
+                for (const int& fId : hg(vId))
+                {
+                    sum += fId;
+                }
+            }
+        }
+
+        return sum;
+    }
+
+
+    // Creates a random sorted subset of [0, universe) with the given density.
+    vector<int> randomSet(size_t universe, double density)
+    {
+        vector<int> set;
+
+        for (size_t i = 0; i < universe; i++)
+        {
+            if (rand() < density * RAND_MAX) set.push_back(i);
+        }
+
+        return set;
+    }
+
+    // Creates a random hypergraph in which a few "heavy" vertices are in most
+    // hyperedges. Each hyperedge contains each heavy vertex with probability
+    // 0.8 and up to 8 other vertices.
+    Hypergraph skewedHypergraph(size_t n, size_t m)
+    {
+        size_t heavy = n / 100 + 1;
+        vector<intPair> list;
+
+        for (size_t eId = 0; eId < m; eId++)
+        {
+            vector<int> vertices;
+
+            for (size_t vId = 0; vId < heavy; vId++)
+            {
+                if (rand() % 10 < 8) vertices.push_back(vId);
+            }
+
+            for (int i = rand() % 8; i >= 0; i--)
+            {
+                vertices.push_back(heavy + rand() % (n - heavy));
+            }
+
+            sort(vertices.begin(), vertices.end());
+            vertices.erase(unique(vertices.begin(), vertices.end()), vertices.end());
+
+            for (const int& vId : vertices)
+            {
+                list.push_back(intPair(eId, vId));
+            }
+        }
+
+        return Hypergraph(list);
+    }
+
+    // Creates a random hypergraph whose vertex degrees follow a power law.
+    // Each hyperedge has 2 to 12 vertices; vertex i is picked with a
+    // probability roughly proportional to 1 / (i + 1).
+    Hypergraph powerLawHypergraph(size_t n, size_t m)
+    {
+        vector<intPair> list;
+
+        for (size_t eId = 0; eId < m; eId++)
+        {
+            vector<int> vertices;
+
+            for (int i = rand() % 11 + 2; i > 0; i--)
+            {
+                double u = (double)rand() / RAND_MAX;
+                size_t vId = (size_t)pow((double)n, u) - 1;
+                vertices.push_back(min(vId, n - 1));
+            }
+
+            sort(vertices.begin(), vertices.end());
+            vertices.erase(unique(vertices.begin(), vertices.end()), vertices.end());
+
+            for (const int& vId : vertices)
+            {
+                list.push_back(intPair(eId, vId));
+            }
+        }
+
+        return Hypergraph(list);
+    }
+
+    // Determines if two graphs have the same edges and weights.
+    bool sameGraph(const Graph& g1, const Graph& g2)
+    {
+        if (g1.size() != g2.size()) return false;
+
+        for (size_t vId = 0; vId < g1.size(); vId++)
+        {
+            if (g1[vId] != g2[vId] || g1(vId) != g2(vId)) return false;
+        }
+
+        return true;
+    }
+
+    // Determines the number of elements in a reduced set.
+    size_t countElements(const ReducedSet& set)
+    {
+        size_t count = 0;
+        for (auto it = set.begin(); it != set.end(); ++it) count++;
+        return count;
+    }
+}
+
+
+// Compares the CSR representation of hypergraphs with an adjacency list
+// that stores each set in its own vector.
+// Measures construction time and the time of a two-hop traversal.
+void Testing::Benchmark::hypergraphLayout(unsigned int seed, size_t tests, size_t maxSize)
+{
+    cout << "\nBenchmark: Hypergraph Layout (CSR vs. Vectors)" << endl
+         << tests << " test cases with max. size " << maxSize << "." << endl;
+
+    srand(seed);
+
+    int64_t csrBuild = 0;
+    int64_t csrTrav = 0;
+    int64_t vecBuild = 0;
+    int64_t vecTrav = 0;
+
+    // Prevents the compiler from removing the traversals.
+    size_t checksum = 0;
+
+    for (size_t tNo = 0; tNo < tests; tNo++)
+    {
+        // --- Generate input. ---
+
+        size_t sz = rand() % maxSize + 5;
+        size_t N = sz + rand() % (sz * LogC(sz)) + 1;
+
+        vector<intPair> list;
+
+        {
+            Hypergraph hg = AlphaAcyclic::genrate(sz, N);
+
+            for (int eId = 0; eId < hg.getESize(); eId++)
+            {
+                for (const int& vId : hg[eId])
+                {
+                    list.push_back(intPair(eId, vId));
+                }
+            }
+        }
+
+
+        // --- CSR ---
+
+        auto start = high_resolution_clock::now();
+        Hypergraph csrHg(list);
+        csrBuild += usSince(start);
+
+        start = high_resolution_clock::now();
+        checksum += twoHops(csrHg);
+        csrTrav += usSince(start);
+
+
+        // --- Vectors ---
+
+        start = high_resolution_clock::now();
+        vecHypergraph vecHg = buildVecHypergraph(list);
+        vecBuild += usSince(start);
+
+        start = high_resolution_clock::now();
+        checksum -= twoHops(vecHg);
+        vecTrav += usSince(start);
+    }
+
+    if (checksum != 0)
+    {
+        cout << "Traversals visited different elements." << endl;
+    }
+
+    printRow("CSR construction    ", csrBuild);
+    printRow("CSR traversal       ", csrTrav);
+    printRow("Vector construction ", vecBuild);
+    printRow("Vector traversal    ", vecTrav);
+}
+
+// Measures the number of intersections of reduced sets per second for
+// each available kernel and various densities.
+// Sets are subsets of [0, universe).
+void Testing::Benchmark::reducedSetIntersection(unsigned int seed, size_t universe, size_t pairs)
+{
+    cout << "\nBenchmark: Intersection of Reduced Sets" << endl
+         << pairs << " pairs of subsets of a universe of size " << universe << "." << endl;
+
+    const double densities[] = { 0.001, 0.01, 0.05, 0.2, 0.5, 0.9 };
+
+    const ReducedSet::Kernel kernels[] =
+    {
+        ReducedSet::Kernel::Scalar,
+        ReducedSet::Kernel::AVX2,
+        ReducedSet::Kernel::AVX512
+    };
+    const string names[] = { "Scalar", "AVX2  ", "AVX512" };
+
+
+    srand(seed);
+
+    for (const double& density : densities)
+    {
+        // --- Generate sets. ---
+
+        vector<ReducedSet> lhs;
+        vector<ReducedSet> rhs;
+
+        for (size_t i = 0; i < pairs; i++)
+        {
+            lhs.push_back(ReducedSet(randomSet(universe, density)));
+            rhs.push_back(ReducedSet(randomSet(universe, density)));
+        }
+
+        cout << "Density " << density << ":" << endl;
+
+
+        // --- Run each kernel. ---
+
+        // Total size of all intersections. Has to be the same for each kernel.
+        size_t expected = 0;
+
+        for (size_t k = 0; k < 3; k++)
+        {
+            if (!ReducedSet::useKernel(kernels[k])) continue;
+
+            // Repeat until at least 200 ms passed to get a reliable measurement.
+            size_t count = 0;
+            auto start = high_resolution_clock::now();
+
+            do
+            {
+                for (size_t i = 0; i < pairs; i++)
+                {
+                    ReducedSet inter = lhs[i] & rhs[i];
+                }
+
+                count += pairs;
+            }
+            while (usSince(start) < 200000);
+
+            int64_t time = usSince(start);
+
+
+            // Verify result.
+            size_t total = 0;
+            for (size_t i = 0; i < pairs; i++)
+            {
+                total += countElements(lhs[i] & rhs[i]);
+            }
+
+            if (k == 0) expected = total;
+            if (total != expected)
+            {
+                cout << "  " << names[k] << " computed wrong intersections." << endl;
+            }
+
+            cout << "  " << names[k] << ": "
+                 << (uint64_t)(count * 1000000.0 / time) << " intersections/s" << endl;
+        }
+    }
+
+    ReducedSet::useKernel(ReducedSet::defaultKernel());
+}
+
+// Compares pritchardReduced() with and without dense sets on a skewed
+// hypergraph (a few vertices are in most hyperedges).
+// Prints the time and how many sets are stored in which format.
+void Testing::Benchmark::adaptiveSets(unsigned int seed, size_t n, size_t m)
+{
+    cout << "\nBenchmark: Adaptive Set Formats in Pritchard's Algorithm" << endl
+         << "Skewed hypergraph with " << n << " vertices and " << m << " hyperedges." << endl;
+
+    srand(seed);
+    Hypergraph hg = skewedHypergraph(max(n, (size_t)2), m);
+
+    const bool adaptive[] = { false, true };
+    const string names[] = { "Reduced ", "Adaptive" };
+
+    size_t expected = 0;
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        SubsetGraph::FormatStats stats;
+
+        // Only count the edges.
+        size_t edges = 0;
+
+        auto start = high_resolution_clock::now();
+        SubsetGraph::pritchardReduced(hg, adaptive[i], &stats, [&edges](int, int) { edges++; });
+        int64_t time = usSince(start);
+
+        if (i == 0) expected = edges;
+        if (edges != expected)
+        {
+            cout << "  " << names[i] << " computed a different subset graph." << endl;
+        }
+
+        printRow(names[i], time);
+
+        cout << "    reduced sets: " << stats.reducedSets << " (" << stats.reducedWords << " words)" << endl
+             << "    dense sets:   " << stats.denseSets << " (" << stats.denseWords << " words)" << endl;
+    }
+}
+
+// Compares the parallel radix sort with the simple (two counting
+// sorts) one. Sorts random lists of pairs with minSize, 10 * minSize,
+// ..., up to maxSize pairs.
+void Testing::Benchmark::radixSort(unsigned int seed, size_t minSize, size_t maxSize)
+{
+    cout << "\nBenchmark: Radix Sort of Integer Pairs" << endl
+         << "Lists with " << minSize << " to " << maxSize << " pairs, "
+         << threadCount() << " threads." << endl;
+
+    srand(seed);
+
+    for (size_t size = max(minSize, (size_t)1); size <= maxSize; size *= 10)
+    {
+        // Similar to edge lists: first values are hyperedges, second values vertices.
+        vector<intPair> input(size);
+        int firstRange = max(size / 8, (size_t)1);
+        int secondRange = min(size, (size_t)numeric_limits<int>::max());
+
+        for (intPair& p : input)
+        {
+            p.first = rand() % firstRange;
+            p.second = rand() % secondRange;
+        }
+
+        cout << size << " pairs:" << endl;
+
+        vector<intPair> simple(input);
+        auto start = high_resolution_clock::now();
+        Sorting::radixSortSimple(simple);
+        printRow("Simple  ", usSince(start));
+
+        // Reuse the input to save memory.
+        start = high_resolution_clock::now();
+        Sorting::radixSort(input);
+        printRow("Parallel", usSince(start));
+
+        if (input != simple)
+        {
+            cout << "  Results differ." << endl;
+        }
+    }
+}
+
+// Compares the linegraph engines of Hypergraph on a hypergraph with n
+// vertices and m hyperedges whose vertex degrees follow a power law.
+void Testing::Benchmark::linegraph(unsigned int seed, size_t n, size_t m)
+{
+    cout << "\nBenchmark: Linegraph Engines" << endl
+         << "Power-law hypergraph with " << n << " vertices and " << m << " hyperedges, "
+         << threadCount() << " threads." << endl;
+
+    srand(seed);
+    Hypergraph hg = powerLawHypergraph(max(n, (size_t)2), m);
+
+    auto start = high_resolution_clock::now();
+    Graph expected = hg.getLinegraph(Hypergraph::LinegraphEngine::Scan);
+    printRow("Scan  ", usSince(start));
+
+    const Hypergraph::LinegraphEngine engines[] =
+    {
+        Hypergraph::LinegraphEngine::Degree,
+        Hypergraph::LinegraphEngine::Auto
+    };
+    const string names[] = { "Degree", "Auto  " };
+
+    for (size_t i = 0; i < 2; i++)
+    {
+        start = high_resolution_clock::now();
+        Graph lg = hg.getLinegraph(engines[i]);
+        printRow(names[i], usSince(start));
+
+        if (!sameGraph(lg, expected))
+        {
+            cout << "  " << names[i] << " computed a different linegraph." << endl;
+        }
+    }
+}
+
+// Measures Interval::getJoinPath() on an interval hypergraph with m
+// hyperedges and total size N, and counts its allocations. Also compares
+// refining with the list of new groups and with a callback.
+void Testing::Benchmark::joinPath(unsigned int seed, size_t m, size_t N)
+{
+    cout << "\nBenchmark: Join Path of Interval Hypergraphs" << endl
+         << "Interval hypergraph with " << m << " hyperedges and size " << N << "." << endl;
+
+    srand(seed);
+    Hypergraph hg = Interval::genrate(max(m, (size_t)2), max(N, m));
+
+    cout << "Generated " << hg.getVSize() << " vertices with total size " << hg.getTotalSize() << "." << endl;
+
+
+    // --- Join path. ---
+
+    size_t allocs = allocationCount();
+    auto start = high_resolution_clock::now();
+
+    vector<int> joinPath = Interval::getJoinPath(hg);
+
+    int64_t time = usSince(start);
+    allocs = allocationCount() - allocs;
+
+    printRow("getJoinPath  ", time);
+    if (countsAllocations())
+    {
+        cout << "    allocations: " << allocs << endl;
+    }
+
+    if (joinPath.empty())
+    {
+        cout << "  No join path found." << endl;
+    }
+
+
+    // --- Refinement. ---
+
+    // Refine with the hyperedges of each vertex, as LexBFS does.
+
+    PartRefinement listPR(hg.getESize());
+    PartRefinement sinkPR(hg.getESize());
+
+    size_t listGroups = 0;
+    size_t sinkGroups = 0;
+
+    start = high_resolution_clock::now();
+    for (int vId = 0; vId < hg.getVSize(); vId++)
+    {
+        listGroups += listPR.refine(hg(vId)).size();
+    }
+    printRow("Refine (list)", usSince(start));
+
+    start = high_resolution_clock::now();
+    for (int vId = 0; vId < hg.getVSize(); vId++)
+    {
+        sinkPR.refine(hg(vId), [&sinkGroups](size_t) { sinkGroups++; });
+    }
+    printRow("Refine (sink)", usSince(start));
+
+    if (listGroups != sinkGroups || listPR.getOrder() != sinkPR.getOrder())
+    {
+        cout << "  Refinements differ." << endl;
+    }
+}
+
+// Compares refining with one list at a time and with batches of
+// lists on a hypergraph with n vertices and m small hyperedges (2 to 5
+// vertices). Refines with each hyperedge and prints the time per list.
+void Testing::Benchmark::batchRefinement(unsigned int seed, size_t n, size_t m)
+{
+    cout << "\nBenchmark: Batched Partition Refinement" << endl
+         << n << " vertices and " << m << " hyperedges with 2 to 5 vertices." << endl;
+
+    srand(seed);
+    n = max(n, (size_t)5);
+
+    vector<intPair> pairs;
+
+    for (int eId = 0; eId < m; eId++)
+    {
+        size_t size = rand() % 4 + 2;
+
+        for (size_t i = 0; i < size; i++)
+        {
+            pairs.push_back(intPair(eId, rand() % n));
+        }
+    }
+
+    // Lists for refinement must not contain duplicates.
+    sort(pairs.begin(), pairs.end());
+    pairs.erase(unique(pairs.begin(), pairs.end()), pairs.end());
+
+    Hypergraph hg(pairs);
+
+    vector<IdSpan> lists;
+    for (int eId = 0; eId < hg.getESize(); eId++)
+    {
+        lists.push_back(hg[eId]);
+    }
+
+
+    // --- One list at a time. ---
+
+    PartRefinement singlePR(hg.getVSize());
+    size_t singleGroups = 0;
+
+    auto start = high_resolution_clock::now();
+    for (const IdSpan& list : lists)
+    {
+        singlePR.refine(list, [&singleGroups](size_t) { singleGroups++; });
+    }
+    int64_t singleTime = usSince(start);
+
+    printRow("Single     ", singleTime);
+    cout << "    ns per list: " << (singleTime * 1000.0) / lists.size() << endl;
+
+
+    // --- Batches. ---
+
+    for (size_t batchSize : { 4, 16, 64, 256 })
+    {
+        PartRefinement batchPR(hg.getVSize());
+        size_t batchGroups = 0;
+
+        vector<IdSpan> batch;
+        batch.reserve(batchSize);
+
+        start = high_resolution_clock::now();
+        for (size_t i = 0; i < lists.size(); i += batchSize)
+        {
+            size_t end = min(i + batchSize, lists.size());
+            batch.assign(lists.begin() + i, lists.begin() + end);
+
+            batchPR.refineBatch(batch, [&batchGroups](size_t) { batchGroups++; });
+        }
+        int64_t batchTime = usSince(start);
+
+        printRow("Batch " + to_string(batchSize) + string(5 - to_string(batchSize).size(), ' '), batchTime);
+        cout << "    ns per list: " << (batchTime * 1000.0) / lists.size() << endl;
+
+
+        // Both have to result in the same groups. Order within groups may differ.
+        bool same = singleGroups == batchGroups && singlePR.size() == batchPR.size();
+
+        const vector<int>& sOrder = singlePR.getOrder();
+        const vector<int>& bOrder = batchPR.getOrder();
+
+        for (size_t i = 0; i < sOrder.size() && same; i++)
+        {
+            same = singlePR.groupOf(sOrder[i]) == singlePR.groupOf(bOrder[i]);
+        }
+
+        if (!same)
+        {
+            cout << "  Refinements differ." << endl;
+        }
+    }
+}
+
+// Compares maximum cardinality search (as in AlphaAcyclic::getJoinTree())
+// with MaxCardinalitySet and with PackedMaxCardinalitySet on an acyclic
+// hypergraph with m hyperedges and total size N. Also measures
+// getJoinTree() itself.
+void Testing::Benchmark::maxCardinalitySearch(unsigned int seed, size_t m, size_t N)
+{
+    cout << "\nBenchmark: Maximum Cardinality Search" << endl
+         << "Acyclic hypergraph with " << m << " hyperedges and size " << N << "." << endl;
+
+    srand(seed);
+    Hypergraph hg = AlphaAcyclic::genrate(max(m, (size_t)2), max(N, m));
+
+    size_t n = hg.getVSize();
+    m = hg.getESize();
+
+    size_t maxSize = 0;
+    for (int eId = 0; eId < m; eId++)
+    {
+        maxSize = max(maxSize, hg[eId].size());
+    }
+
+
+    // --- MaxCardinalitySet ---
+
+    // Both searches process each vertex once, as getJoinTree() does.
+
+    vector<int> order;
+    order.reserve(m);
+
+    vector<bool> vProcessed(n, false);
+
+    auto start = high_resolution_clock::now();
+    for (MaxCardinalitySet sets(m); !sets.isEmpty(); )
+    {
+        int S = sets.removeMax();
+        order.push_back(S);
+
+        for (const int& vId : hg[S])
+        {
+            if (vProcessed[vId]) continue;
+            vProcessed[vId] = true;
+
+            for (const int& eId : hg(vId))
+            {
+                if (eId != S) sets.increaseSize(eId);
+            }
+        }
+    }
+    printRow("Vector sets ", usSince(start));
+
+
+    // --- PackedMaxCardinalitySet ---
+
+    vector<int> packedOrder;
+    packedOrder.reserve(m);
+
+    vProcessed.assign(n, false);
+
+    start = high_resolution_clock::now();
+    for (PackedMaxCardinalitySet sets(m, maxSize); !sets.isEmpty(); )
+    {
+        int S = sets.removeMax();
+        packedOrder.push_back(S);
+
+        for (const int& vId : hg[S])
+        {
+            if (vProcessed[vId]) continue;
+            vProcessed[vId] = true;
+
+            sets.increaseSizes(hg(vId));
+        }
+    }
+    printRow("Packed sets ", usSince(start));
+
+    if (order != packedOrder)
+    {
+        cout << "  Orders differ." << endl;
+    }
+
+
+    // --- Join tree. ---
+
+    start = high_resolution_clock::now();
+    vector<int> joinTree = AlphaAcyclic::getJoinTree(hg);
+    printRow("getJoinTree ", usSince(start));
+
+    if (joinTree.empty())
+    {
+        cout << "  No join tree found." << endl;
+    }
+}
+
+// Compares the update latency of IncrementalUnionJoin with recomputing
+// the union join graph from scratch. Starts with an acyclic hypergraph
+// with m hyperedges and total size N. Each update removes a random
+// hyperedge and inserts it again.
+void Testing::Benchmark::incrementalUnionJoin(unsigned int seed, size_t m, size_t N, size_t updates)
+{
+    cout << "\nBenchmark: Incremental Union Join Graph" << endl
+         << "Acyclic hypergraph with " << m << " hyperedges and size " << N << ", "
+         << updates << " updates." << endl;
+
+    srand(seed);
+    Hypergraph hg = AlphaAcyclic::genrate(max(m, (size_t)2), max(N, m));
+
+    auto start = high_resolution_clock::now();
+    IncrementalUnionJoin iuj(hg);
+    printRow("Initial build ", usSince(start));
+
+
+    // --- Updates. ---
+
+    vector<int> aliveIds;
+    for (int eId = 0; eId < iuj.size(); eId++)
+    {
+        if (iuj.contains(eId)) aliveIds.push_back(eId);
+    }
+
+    size_t rebuilds = iuj.rebuildCount();
+    int64_t removeTime = 0;
+    int64_t insertTime = 0;
+
+    for (size_t i = 0; i < updates && !aliveIds.empty(); i++)
+    {
+        size_t idx = rand() % aliveIds.size();
+        int eId = aliveIds[idx];
+        vector<int> vList = iuj[eId];
+
+        start = high_resolution_clock::now();
+        iuj.remove(eId);
+        removeTime += usSince(start);
+
+        start = high_resolution_clock::now();
+        aliveIds[idx] = iuj.insert(vList);
+        insertTime += usSince(start);
+    }
+
+    const size_t count = max(updates, (size_t)1);
+    cout << "  Average remove: " << removeTime / count << "us" << endl
+         << "  Average insert: " << insertTime / count << "us" << endl
+         << "  Rebuilds:       " << iuj.rebuildCount() - rebuilds << endl;
+
+
+    // --- Full recomputation. ---
+
+    // Same hypergraph with consecutive hyperedge IDs.
+    vector<intPair> pairs;
+    for (size_t i = 0; i < aliveIds.size(); i++)
+    {
+        for (const int& vId : iuj[aliveIds[i]])
+        {
+            pairs.push_back(intPair(i, vId));
+        }
+    }
+
+    Hypergraph current(pairs);
+
+    start = high_resolution_clock::now();
+    Graph full = AlphaAcyclic::unionJoinGraph(current);
+    int64_t fullTime = usSince(start);
+
+    cout << "  Full recompute: " << fullTime << "us" << endl;
+
+
+    // --- Compare edges. ---
+
+    // Maps hyperedge IDs of iuj to the ones in current.
+    vector<int> idMap(iuj.size(), -1);
+    for (size_t i = 0; i < aliveIds.size(); i++)
+    {
+        idMap[aliveIds[i]] = i;
+    }
+
+    Graph inc = iuj.unionJoinGraph();
+    bool same = true;
+
+    for (int eId = 0; eId < inc.size() && same; eId++)
+    {
+        // Loops only ensure that all vertices exist.
+        vector<int> incNeighs;
+        for (const int& nId : inc[eId])
+        {
+            if (nId != eId) incNeighs.push_back(idMap[nId]);
+        }
+
+        sort(incNeighs.begin(), incNeighs.end());
+
+        vector<int> fullNeighs;
+        if (idMap[eId] >= 0) fullNeighs = full[idMap[eId]];
+        sort(fullNeighs.begin(), fullNeighs.end());
+
+        same = incNeighs == fullNeighs;
+    }
+
+    if (!same)
+    {
+        cout << "  Union join graphs differ." << endl;
+    }
+}
@@ -0,0 +1,62 @@
+// Contains benchmarks to compare different implementations and data structures.
+
+#ifndef __Testing_Benchmark_H__
+#define __Testing_Benchmark_H__
+
+
+#include <cstddef>
+
+
+namespace Testing
+{
+    namespace Benchmark
+    {
+        // Compares the CSR representation of hypergraphs with an adjacency list
+        // that stores each set in its own vector.
+        // Measures construction time and the time of a two-hop traversal.
+        void hypergraphLayout(unsigned int seed, size_t tests, size_t maxSize);
+
+        // Measures the number of intersections of reduced sets per second for
+        // each available kernel and various densities.
+        // Sets are subsets of [0, universe).
+        void reducedSetIntersection(unsigned int seed, size_t universe, size_t pairs);
+
+        // Compares pritchardReduced() with and without dense sets on a skewed
+        // hypergraph (a few vertices are in most hyperedges).
+        // Prints the time and how many sets are stored in which format.
+        void adaptiveSets(unsigned int seed, size_t n, size_t m);
+
+        // Compares the parallel radix sort with the simple (two counting
+        // sorts) one. Sorts random lists of pairs with minSize, 10 * minSize,
+        // ..., up to maxSize pairs.
+        void radixSort(unsigned int seed, size_t minSize, size_t maxSize);
+
+        // Compares the linegraph engines of Hypergraph on a hypergraph with n
+        // vertices and m hyperedges whose vertex degrees follow a power law.
+        void linegraph(unsigned int seed, size_t n, size_t m);
+
+        // Measures Interval::getJoinPath() on an interval hypergraph with m
+        // hyperedges and total size N, and counts its allocations. Also compares
+        // refining with the list of new groups and with a callback.
+        void joinPath(unsigned int seed, size_t m, size_t N);
+
+        // Compares refining with one list at a time and with batches of
+        // lists on a hypergraph with n vertices and m small hyperedges (2 to 5
+        // vertices). Refines with each hyperedge and prints the time per list.
+        void batchRefinement(unsigned int seed, size_t n, size_t m);
+
+        // Compares maximum cardinality search (as in AlphaAcyclic::getJoinTree())
+        // with MaxCardinalitySet and with PackedMaxCardinalitySet on an acyclic
+        // hypergraph with m hyperedges and total size N. Also measures
+        // getJoinTree() itself.
+        void maxCardinalitySearch(unsigned int seed, size_t m, size_t N);
+
+        // Compares the update latency of IncrementalUnionJoin with recomputing
+        // the union join graph from scratch. Starts with an acyclic hypergraph
+        // with m hyperedges and total size N. Each update removes a random
+        // hyperedge and inserts it again.
+        void incrementalUnionJoin(unsigned int seed, size_t m, size_t N, size_t updates);
+    }
+}
+
+#endif
@@ -1,7 +1,19 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <chrono>
 
 #include "../algorithms/alphaAcyclic.h"
+#include "../algorithms/gammaAcyclic.h"
+#include "../algorithms/interval.h"
+#include "../dataStructures/incrementalUnionJoin.h"
+#include "../dataStructures/maxCardinalitySet.h"
+#include "../dataStructures/partRefine.h"
+#include "../dataStructures/reducedSet.h"
+#include "../dataStructures/unionFind.h"
+#include "allocationCounter.h"
 #include "subsetTest.h"
 #include "testing.h"
 
@@ -15,8 +27,356 @@ using namespace std::chrono;
 #endif
 
 
+// Anonymous namespace for helper functions.
+namespace
+{
+    // Determines if two hypergraphs have the same sets of vertices and hyperedges.
+    bool sameHypergraph(const Hypergraph& hg1, const Hypergraph& hg2)
+    {
+        if (hg1.getVSize() != hg2.getVSize() || hg1.getESize() != hg2.getESize()) return false;
+        if (hg1.getTotalSize() != hg2.getTotalSize()) return false;
+
+        for (int eId = 0; eId < hg1.getESize(); eId++)
+        {
+            if (hg1[eId].toVector() != hg2[eId].toVector()) return false;
+        }
+
+        for (int vId = 0; vId < hg1.getVSize(); vId++)
+        {
+            if (hg1(vId).toVector() != hg2(vId).toVector()) return false;
+        }
+
+        return true;
+    }
+
+    // Creates a hypergraph with n vertices and m hyperedges whose vertex
+    // degrees follow a power law. Each hyperedge has 2 to 12 vertices.
+    Hypergraph powerLawHypergraph(int n, int m)
+    {
+        vector<intPair> pairs;
+
+        for (int eId = 0; eId < m; eId++)
+        {
+            for (int i = rand() % 11 + 2; i > 0; i--)
+            {
+                double u = (double)rand() / RAND_MAX;
+                int vId = (int)pow((double)n, u) - 1;
+                pairs.push_back(intPair(eId, min(max(vId, 0), n - 1)));
+            }
+        }
+
+        sort(pairs.begin(), pairs.end());
+        pairs.erase(unique(pairs.begin(), pairs.end()), pairs.end());
+
+        return Hypergraph(pairs);
+    }
+
+    // Creates a hypergraph with m hyperedges in which each of heavyCount
+    // vertices is in about a quarter of all hyperedges. Each hyperedge also
+    // has a few random vertices of n others.
+    Hypergraph heavyHypergraph(int n, int m, int heavyCount)
+    {
+        vector<intPair> pairs;
+
+        for (int eId = 0; eId < m; eId++)
+        {
+            for (int vId = 0; vId < heavyCount; vId++)
+            {
+                if (rand() % 4 == 0) pairs.push_back(intPair(eId, vId));
+            }
+
+            for (int i = rand() % 4; i > 0; i--)
+            {
+                pairs.push_back(intPair(eId, heavyCount + rand() % n));
+            }
+        }
+
+        sort(pairs.begin(), pairs.end());
+        pairs.erase(unique(pairs.begin(), pairs.end()), pairs.end());
+
+        return Hypergraph(pairs);
+    }
+
+    // Determines if two graphs have the same edges and weights.
+    bool sameGraph(const Graph& g1, const Graph& g2)
+    {
+        if (g1.size() != g2.size()) return false;
+
+        for (size_t vId = 0; vId < g1.size(); vId++)
+        {
+            if (g1[vId] != g2[vId] || g1(vId) != g2(vId)) return false;
+        }
+
+        return true;
+    }
+
+    // Returns the elements of the given reduced set.
+    vector<int> elements(const ReducedSet& set)
+    {
+        vector<int> list;
+        for (auto it = set.begin(); it != set.end(); ++it) list.push_back(*it);
+        return list;
+    }
+
+    // Creates a random sorted subset of [0, universe). Elements are spread
+    // out, dense, or clustered in a few ranges, so that sets have mostly
+    // zero words, few zero words, or both.
+    vector<int> randomSubset(int universe)
+    {
+        vector<int> list;
+        int mode = rand() % 3;
+
+        for (int x = 0; x < universe; x++)
+        {
+            bool add =
+                mode == 0 ? rand() % 100 == 0 :
+                mode == 1 ? rand() % 2 == 0 :
+                (x / 512) % 3 == 0 && rand() % 4 != 0;
+
+            if (add) list.push_back(x);
+        }
+
+        return list;
+    }
+
+    // Creates a random hypergraph with n vertices and m hyperedges, each with
+    // up to maxSize vertices. Some vertices and hyperedges may be empty.
+    Hypergraph randomHypergraph(int n, int m, int maxSize)
+    {
+        vector<intPair> pairs;
+
+        for (int eId = 0; eId < m; eId++)
+        {
+            int size = rand() % (maxSize + 1);
+            for (int i = 0; i < size; i++)
+            {
+                pairs.push_back(intPair(eId, rand() % n));
+            }
+        }
+
+        sort(pairs.begin(), pairs.end());
+        pairs.erase(unique(pairs.begin(), pairs.end()), pairs.end());
+
+        return Hypergraph(pairs);
+    }
+
+    // Compares the current state of an IncrementalUnionJoin with computing
+    // everything from scratch. Returns an error message, or an empty string
+    // if there is no difference.
+    string checkIncremental(const IncrementalUnionJoin& iuj)
+    {
+        // --- Compacted copy. ---
+
+        // Maps alive hyperedges to consecutive IDs.
+        vector<int> idMap(iuj.size(), -1);
+        vector<int> aliveIds;
+        vector<intPair> pairs;
+
+        for (int eId = 0; eId < iuj.size(); eId++)
+        {
+            if (!iuj.contains(eId)) continue;
+
+            idMap[eId] = aliveIds.size();
+            for (const int& vId : iuj[eId])
+            {
+                pairs.push_back(intPair(aliveIds.size(), vId));
+            }
+
+            aliveIds.push_back(eId);
+        }
+
+        // An empty hypergraph is acyclic.
+        if (aliveIds.empty())
+        {
+            return iuj.isAcyclic() ? "" : "Empty hypergraph is not acyclic.";
+        }
+
+        Hypergraph hg(pairs);
+        bool acyclic = !AlphaAcyclic::getJoinTree(hg).empty();
+
+        if (iuj.isAcyclic() != acyclic)
+        {
+            return "Acyclicity differs.";
+        }
+
+
+        // --- Expected union join graph. ---
+
+        // AlphaAcyclic expects a connected hypergraph. Hence, compute the
+        // union join graph of each component. Hyperedges in different
+        // components can be joined by an empty separator; they are adjacent.
+
+        size_t k = aliveIds.size();
+        vector<vector<int>> expected(k);
+
+        if (acyclic)
+        {
+            UnionFind uf(k);
+            for (int vId = 0; vId < hg.getVSize(); vId++)
+            {
+                IdSpan eIds = hg(vId);
+                for (size_t i = 1; i < eIds.size(); i++) uf.unionSets(eIds[0], eIds[i]);
+            }
+
+            // Hyperedges of each component, identified by its root.
+            vector<vector<int>> compIds(k);
+            for (int eId = 0; eId < k; eId++)
+            {
+                compIds[uf.findSet(eId)].push_back(eId);
+            }
+
+            for (const vector<int>& comp : compIds)
+            {
+                if (comp.size() < 2) continue;
+
+                // Compacted component (hyperedges and vertices).
+                vector<int> vMap(hg.getVSize(), -1);
+                vector<intPair> compPairs;
+                int vCount = 0;
+
+                for (int i = 0; i < comp.size(); i++)
+                {
+                    for (const int& vId : hg[comp[i]])
+                    {
+                        if (vMap[vId] < 0) vMap[vId] = vCount++;
+                        compPairs.push_back(intPair(i, vMap[vId]));
+                    }
+                }
+
+                Graph compUjg = AlphaAcyclic::unionJoinGraph(Hypergraph(compPairs));
+
+                for (int i = 0; i < comp.size(); i++)
+                {
+                    for (const int& j : compUjg[i])
+                    {
+                        expected[comp[i]].push_back(comp[j]);
+                    }
+                }
+            }
+
+            for (int xId = 0; xId < k; xId++)
+            {
+                for (int yId = 0; yId < k; yId++)
+                {
+                    if (uf.findSet(xId) != uf.findSet(yId)) expected[xId].push_back(yId);
+                }
+            }
+        }
+
+
+        // --- Compare union join graphs. ---
+
+        Graph inc = iuj.unionJoinGraph();
+
+        for (int eId = 0; eId < inc.size(); eId++)
+        {
+            // Loops only ensure that all vertices exist.
+            vector<int> incNeighs;
+            for (const int& nId : inc[eId])
+            {
+                if (nId != eId) incNeighs.push_back(nId);
+            }
+
+            if (!iuj.contains(eId))
+            {
+                if (!incNeighs.empty()) return "Removed hyperedge has neighbours.";
+                continue;
+            }
+
+            for (int& nId : incNeighs)
+            {
+                if (!iuj.contains(nId)) return "Edge to removed hyperedge.";
+                nId = idMap[nId];
+            }
+
+            vector<int>& expNeighs = expected[idMap[eId]];
+
+            sort(incNeighs.begin(), incNeighs.end());
+            sort(expNeighs.begin(), expNeighs.end());
+
+            if (incNeighs != expNeighs) return "Union join graphs differ.";
+        }
+
+        if (!acyclic) return "";
+
+
+        // --- Join tree and separators. ---
+
+        // A spanning tree is a join tree if and only if its separators are
+        // the intersections of its endpoints and their total size is the sum
+        // of d(v) - 1 over all vertices.
+
+        size_t bound = 0;
+        for (int vId = 0; vId < hg.getVSize(); vId++)
+        {
+            if (hg(vId).size() > 0) bound += hg(vId).size() - 1;
+        }
+
+        const map<intPair, vector<int>>& seps = iuj.separators();
+        size_t weight = 0;
+        size_t edges = 0;
+
+        for (const int& xId : aliveIds)
+        {
+            for (const intPair& p : iuj.joinTree(xId))
+            {
+                int yId = p.first;
+                if (!iuj.contains(yId)) return "Join tree contains removed hyperedge.";
+                if (yId > xId) continue;
+
+                const vector<int>& X = iuj[xId];
+                const vector<int>& Y = iuj[yId];
+
+                vector<int> S;
+                set_intersection(X.begin(), X.end(), Y.begin(), Y.end(), back_inserter(S));
+
+                auto it = seps.find(intPair(xId, yId));
+                if (it == seps.end() || it->second != S || p.second != S.size())
+                {
+                    return "Wrong separator.";
+                }
+
+                weight += S.size();
+                edges++;
+            }
+        }
+
+        if (edges != aliveIds.size() - 1 || seps.size() != edges)
+        {
+            return "Join tree has wrong number of edges.";
+        }
+
+        // Connected?
+        vector<bool> visited(iuj.size(), false);
+        vector<int> stack = { aliveIds[0] };
+        size_t found = 1;
+        visited[aliveIds[0]] = true;
+
+        while (!stack.empty())
+        {
+            int xId = stack.back();
+            stack.pop_back();
+
+            for (const intPair& p : iuj.joinTree(xId))
+            {
+                if (visited[p.first]) continue;
+
+                visited[p.first] = true;
+                stack.push_back(p.first);
+                found++;
+            }
+        }
+
+        if (found != aliveIds.size()) return "Join tree is not connected.";
+        if (weight != bound) return "Join tree has wrong weight.";
+
+        return "";
+    }
+}
+
+
 // Tests a given function that computes the subset graph of a given hypergraph.
-void Testing::testGeneralSSG(SubsetGraph::ssgAlgo ssg, int seed, int tests, int maxSize)
+bool Testing::testGeneralSSG(SubsetGraph::ssgAlgo ssg, int seed, int tests, int maxSize)
 {
     srand(seed);
 
@@ -85,41 +445,55 @@ void Testing::testGeneralSSG(SubsetGraph::ssgAlgo ssg, int seed, int tests, int
     {
         cout << "All tests passed." << endl;
     }
+
+    return allPassed;
 }
 
-// Tests a given function that computes the subset graph of a given hypergraph.
-// Returns the time needed in milliseconds.
-uint64_t Testing::unionJoinGraph(ujgAlgo algo, string name, unsigned int seed, size_t tests, size_t maxSize)
+// Tests the parallel subset graph algorithm with multiple threads and more
+// hyperedges than one block contains.
+bool Testing::parallelSSG(unsigned int seed, size_t tests, size_t maxSize)
 {
-    cout << "\nTesting Union Join Graph Implementation: " << name << endl
+    cout << "\nTesting Parallel Subset Graph Implementation." << endl
          << tests << " test cases with max. size " << maxSize << "." << endl;
 
 
     srand(seed);
-    auto start = high_resolution_clock::now();
+    bool allPassed = true;
 
 
-    for (size_t tNo = 1, perc = -1; tNo < tests; tNo++)
+    for (size_t tNo = 1, perc = -1; tNo <= tests && allPassed; tNo++)
     {
-        // --- Determine size and create hypergraph. ---
+        // --- Create hypergraph. ---
 
-        size_t sz = rand() % maxSize + 5;
-        size_t N = sz + rand() % (sz * LogC(sz)) + 1;
+        // Blocks contain 256 hyperedges. Hence, there are at least three blocks.
+        SubsetTest sst;
+        int size = rand() % maxSize + 600;
+        const Hypergraph& hg = sst.build(size);
 
-        Hypergraph aaHg = AlphaAcyclic::genrate(sz, N);
+        size_t threads = rand() % 4 + 2;
 
 
-        // --- Run tests. ---
+        // --- Run test. ---
 
         try
         {
-            Graph ujg = algo(aaHg);
+            setThreadCount(threads);
+            vector<intPair> answer = SubsetGraph::pritchardParallel(hg);
+            setThreadCount(0);
+
+            if (!sst.verify(answer))
+            {
+                cout << "Test " << tNo << " failed with " << threads << " threads." << endl;
+                allPassed = false;
+            }
         }
         catch (const exception& e)
         {
+            setThreadCount(0);
+
             cout << "Test " << tNo << " failed with exception." << endl;
             cerr << e.what() << endl;
-            break;
+            allPassed = false;
         }
 
 
@@ -134,53 +508,1347 @@ uint64_t Testing::unionJoinGraph(ujgAlgo algo, string name, unsigned int seed, s
         }
     }
 
-    auto end = high_resolution_clock::now();
-    return duration_cast<milliseconds>(end - start).count();
+    if (allPassed)
+    {
+        cout << "All tests passed." << endl;
+    }
+
+    return allPassed;
 }
 
-// Tests if two given algorithms return the same result.
-bool Testing::unionJoinGraph(ujgAlgo algo1, ujgAlgo algo2, unsigned int seed, size_t tests, size_t maxSize)
+// Tests that the loop of pritchardRefinement() only allocates memory when
+// its history grows, i.e., a logarithmic number of times.
+bool Testing::pritchardAllocations(unsigned int seed, size_t tests, size_t maxSize)
 {
-    cout << "\nTesting Result of Union Join Graph Implementations." << endl
+    cout << "\nTesting Allocations of Pritchard's Algorithm." << endl
          << tests << " test cases with max. size " << maxSize << "." << endl;
 
+    if (!countsAllocations())
+    {
+        cout << "Test skipped: allocations are not counted (build with COUNT_ALLOCATIONS)." << endl;
+        return false;
+    }
+
 
     srand(seed);
     bool allPassed = true;
 
 
-    for (size_t tNo = 1, perc = -1; tNo < tests; tNo++)
+    for (size_t tNo = 1, perc = -1; tNo <= tests && allPassed; tNo++)
     {
-        // --- Determine size and create hypergraph. ---
+        // --- Create hypergraph. ---
 
-        size_t sz = rand() % maxSize + 5;
-        size_t N = sz + rand() % (sz * LogC(sz)) + 1;
+        SubsetTest sst;
+        const Hypergraph& hg = sst.build(rand() % maxSize + 50);
 
-        Hypergraph aaHg = AlphaAcyclic::genrate(sz, N);
+        size_t N = 0;
+        for (int eId = 0; eId < hg.getESize(); eId++)
+        {
+            N += hg[eId].size();
+        }
 
 
-        // --- Run tests. ---
+        // --- Count allocations. ---
 
-        bool equal = false;
+        // The sink is called within the loop. Hence, all allocations between
+        // the first and the last edge happen in the loop.
+
+        size_t edges = 0;
+        size_t first = 0;
+        size_t last = 0;
+
+        auto sink = [&edges, &first, &last](int, int)
+        {
+            size_t count = allocationCount();
+            if (edges == 0) first = count;
+            last = count;
+            edges++;
+        };
 
         try
         {
-            equal = UnionJoinTest::compareAlgorithms(aaHg, algo1, algo2);
+            SubsetGraph::pritchardRefinement(hg, sink);
+
+            // The buffer of the history has at most N^2 entries and its two
+            // lists at most N. All three grow geometrically.
+            size_t bound = 4 * LogC(N + 1) + 3;
+
+            if (last - first > bound)
+            {
+                cout << "Test " << tNo << " failed: " << (last - first) << " allocations for "
+                     << edges << " edges (at most " << bound << " expected)." << endl;
+                allPassed = false;
+            }
         }
         catch (const exception& e)
         {
             cout << "Test " << tNo << " failed with exception." << endl;
             cerr << e.what() << endl;
             allPassed = false;
-            break;
         }
 
 
-        if (!equal)
+        // --- Print progress. ---
+
+        int progress = (tNo * 100) / tests;
+
+        if (progress != perc)
         {
-            cout << "Test " << tNo << " failed." << endl;
+            perc = progress;
+            cout << perc << " %\r" << flush;
+        }
+    }
+
+    if (allPassed)
+    {
+        cout << "All tests passed." << endl;
+    }
+
+    return allPassed;
+}
+
+// Tests if the linegraph engines (Scan, Degree, and Auto) compute the same
+// linegraph. Uses random and power-law hypergraphs, and hypergraphs with
+// no heavy vertex and with more than 64 heavy vertices.
+bool Testing::linegraphEngines(unsigned int seed, size_t tests, size_t maxSize)
+{
+    cout << "\nTesting Linegraph Engines." << endl
+         << tests << " test cases with max. size " << maxSize << "." << endl;
+
+
+    srand(seed);
+    bool allPassed = true;
+
+    const vector<string> kinds = { "random", "power-law", "no heavy vertex", "many heavy vertices" };
+
+
+    for (size_t tNo = 1, perc = -1; tNo <= tests && allPassed; tNo++)
+    {
+        // --- Create hypergraph. ---
+
+        int n = rand() % maxSize + 5;
+        int m = rand() % maxSize + 5;
+        size_t kind = tNo % kinds.size();
+
+        Hypergraph hg =
+            kind == 0 ? randomHypergraph(n, m, rand() % 20 + 1) :
+            kind == 1 ? powerLawHypergraph(n, m) :
+            // Few hyperedges per vertex. Heavy vertices need at least 8.
+            kind == 2 ? randomHypergraph(8 * m, m + 64, 2) :
+            // More heavy vertices than fit into the bitsets.
+            heavyHypergraph(n, m + 16, 64 + rand() % 64 + 1);
+
+
+        // --- Compare engines. ---
+
+        try
+        {
+            Graph scan = hg.getLinegraph(Hypergraph::LinegraphEngine::Scan);
+            Graph degree = hg.getLinegraph(Hypergraph::LinegraphEngine::Degree);
+            Graph autoLg = hg.getLinegraph(Hypergraph::LinegraphEngine::Auto);
+
+            if (!sameGraph(scan, degree) || !sameGraph(scan, autoLg))
+            {
+                cout << "Test " << tNo << " failed: linegraphs of "
+                     << kinds[kind] << " hypergraph differ." << endl;
+                allPassed = false;
+            }
+        }
+        catch (const exception& e)
+        {
+            cout << "Test " << tNo << " failed with exception." << endl;
+            cerr << e.what() << endl;
+            allPassed = false;
+        }
+
+
+        // --- Print progress. ---
+
+        int progress = (tNo * 100) / tests;
+
+        if (progress != perc)
+        {
+            perc = progress;
+            cout << perc << " %\r" << flush;
+        }
+    }
+
+    if (allPassed)
+    {
+        cout << "All tests passed." << endl;
+    }
+
+    return allPassed;
+}
+
+// Tests saving and loading hypergraphs in binary files, with and without
+// sets of vertices. Also verifies that corrupted files are rejected.
+bool Testing::hypergraphFiles(unsigned int seed, size_t tests, size_t maxSize)
+{
+    cout << "\nTesting Binary Hypergraph Files." << endl
+         << tests << " test cases with max. size " << maxSize << "." << endl;
+
+
+    srand(seed);
+    bool allPassed = true;
+
+    const string path = "hypergraphTest.bin";
+
+
+    for (size_t tNo = 1, perc = -1; tNo <= tests && allPassed; tNo++)
+    {
+        // --- Create hypergraph. ---
+
+        int n = rand() % maxSize + 1;
+        int m = rand() % maxSize + 1;
+
+        Hypergraph hg = randomHypergraph(n, m, rand() % 10 + 1);
+
+
+        // --- Save and load. ---
+
+        try
+        {
+            for (bool withVSets : { false, true })
+            {
+                hg.save(path, withVSets);
+
+                for (bool trusted : { false, true })
+                {
+                    Hypergraph loaded = Hypergraph::load(path, trusted);
+
+                    if (!sameHypergraph(hg, loaded))
+                    {
+                        cout << "Test " << tNo << " failed: loaded hypergraph differs "
+                             << "(vertex sets: " << withVSets << ", trusted: " << trusted << ")." << endl;
+                        allPassed = false;
+                    }
+                }
+
+                if (hg.getTotalSize() == 0) continue;
+
+
+                // --- Corrupt file. ---
+
+                // The file ends with the last incidence of the last vertex
+                // (or hyperedge without vertex sets). Both are not empty.
+
+                for (int badId : { -1, withVSets ? hg.getESize() : hg.getVSize(), 0 })
+                {
+                    // Use an ID that breaks sortedness (or is a duplicate).
+                    if (badId == 0)
+                    {
+                        IdSpan last = withVSets ? hg(hg.getVSize() - 1) : hg[hg.getESize() - 1];
+                        if (last.size() < 2) continue;
+
+                        badId = last[last.size() - 2];
+                    }
+
+                    hg.save(path, withVSets);
+
+                    // Overwrite the last 4 bytes.
+                    {
+                        fstream file(path, ios::binary | ios::in | ios::out);
+                        file.seekp(-(int)sizeof(int), ios::end);
+                        file.write((const char*)&badId, sizeof(int));
+                    }
+
+                    bool rejected = false;
+                    try
+                    {
+                        Hypergraph loaded = Hypergraph::load(path);
+                    }
+                    catch (const runtime_error&)
+                    {
+                        rejected = true;
+                    }
+
+                    if (!rejected)
+                    {
+                        cout << "Test " << tNo << " failed: corrupted file with ID " << badId
+                             << " accepted (vertex sets: " << withVSets << ")." << endl;
+                        allPassed = false;
+                    }
+                }
+            }
+        }
+        catch (const exception& e)
+        {
+            cout << "Test " << tNo << " failed with exception." << endl;
+            cerr << e.what() << endl;
+            allPassed = false;
+        }
+
+
+        // --- Print progress. ---
+
+        int progress = (tNo * 100) / tests;
+
+        if (progress != perc)
+        {
+            perc = progress;
+            cout << perc << " %\r" << flush;
+        }
+    }
+
+    remove(path.c_str());
+
+    if (allPassed)
+    {
+        cout << "All tests passed." << endl;
+    }
+
+    return allPassed;
+}
+
+// Tests reading hypergraphs from text files in both formats. Files contain
+// comments, empty lines, repeated pairs, and sometimes no final line
+// break. Also reads one file that is large enough to be split into chunks.
+bool Testing::hypergraphText(unsigned int seed, size_t tests, size_t maxSize)
+{
+    cout << "\nTesting Text Hypergraph Files." << endl
+         << tests << " test cases with max. size " << maxSize << "." << endl;
+
+
+    srand(seed);
+    bool allPassed = true;
+
+    const string path = "hypergraphTest.txt";
+
+    // Reads the file and compares the result with the given hypergraph.
+    auto check = [&](const Hypergraph& hg, Hypergraph::TextFormat format, const string& name, size_t tNo)
+    {
+        Hypergraph read = Hypergraph::read(path, format);
+
+        if (!sameHypergraph(hg, read))
+        {
+            cout << "Test " << tNo << " failed: " << name << " differs." << endl;
+            allPassed = false;
+        }
+    };
+
+    // Randomly chooses a line break, sometimes with carriage return or spaces.
+    auto lineBreak = []() -> string
+    {
+        switch (rand() % 4)
+        {
+            case 0: return "\r\n";
+            case 1: return " \t\n";
+            default: return "\n";
+        }
+    };
+
+
+    // Test number 0 uses a large hypergraph. Its files are read in chunks.
+    for (size_t tNo = 0, perc = -1; tNo <= tests && allPassed; tNo++)
+    {
+        // --- Create hypergraph. ---
+
+        int n = tNo == 0 ? 100000 : rand() % maxSize + 1;
+        int m = tNo == 0 ? 100000 : rand() % maxSize + 1;
+
+        Hypergraph hg = randomHypergraph(n, m, tNo == 0 ? 50 : rand() % 10 + 1);
+
+        // Files without final line break.
+        bool noFinalBreak = rand() % 2 == 0;
+
+        try
+        {
+            // --- Sets: print() ---
+
+            {
+                ofstream out(path);
+                hg.print(out);
+            }
+
+            check(hg, Hypergraph::TextFormat::Sets, "print()", tNo);
+
+
+            // --- Sets: comments, repeated lines and vertices. ---
+
+            {
+                ofstream out(path);
+                out << "# Hypergraph" << lineBreak();
+
+                for (int eId = 0; eId < hg.getESize(); eId++)
+                {
+                    for (int rep = rand() % 10 == 0 ? 2 : 1; rep > 0; rep--)
+                    {
+                        if (rand() % 10 == 0) out << lineBreak();
+                        if (rand() % 10 == 0) out << "# Comment " << eId << lineBreak();
+
+                        out << (rand() % 2 == 0 ? " " : "") << eId << " :";
+
+                        for (const int& vId : hg[eId])
+                        {
+                            out << (rand() % 2 == 0 ? " " : "\t") << vId;
+                            if (rand() % 10 == 0) out << " " << vId;
+                        }
+
+                        bool last = eId == hg.getESize() - 1 && rep == 1;
+                        if (!last || !noFinalBreak) out << lineBreak();
+                    }
+                }
+            }
+
+            check(hg, Hypergraph::TextFormat::Sets, "sets with comments", tNo);
+
+
+            // --- Pairs: shuffled, comments, repeated pairs. ---
+
+            vector<intPair> pairs;
+            for (int eId = 0; eId < hg.getESize(); eId++)
+            {
+                for (const int& vId : hg[eId])
+                {
+                    pairs.push_back(intPair(eId, vId));
+                    if (rand() % 10 == 0) pairs.push_back(intPair(eId, vId));
+                }
+            }
+
+            random_shuffle(pairs.begin(), pairs.end());
+
+            {
+                ofstream out(path);
+                out << "# Pairs" << lineBreak();
+
+                for (size_t i = 0; i < pairs.size(); i++)
+                {
+                    if (rand() % 20 == 0) out << lineBreak();
+                    if (rand() % 20 == 0) out << "#" << lineBreak();
+
+                    out << pairs[i].first << (rand() % 2 == 0 ? " " : "\t ") << pairs[i].second;
+                    if (i + 1 < pairs.size() || !noFinalBreak) out << lineBreak();
+                }
+            }
+
+            check(hg, Hypergraph::TextFormat::Pairs, "pairs", tNo);
+
+
+            // --- Invalid line. ---
+
+            {
+                ofstream out(path);
+                out << "0 1\n1 x\n";
+            }
+
+            bool rejected = false;
+            try
+            {
+                Hypergraph::read(path, Hypergraph::TextFormat::Pairs);
+            }
+            catch (const invalid_argument&)
+            {
+                rejected = true;
+            }
+
+            if (!rejected)
+            {
+                cout << "Test " << tNo << " failed: invalid file accepted." << endl;
+                allPassed = false;
+            }
+        }
+        catch (const exception& e)
+        {
+            cout << "Test " << tNo << " failed with exception." << endl;
+            cerr << e.what() << endl;
+            allPassed = false;
+        }
+
+
+        // --- Print progress. ---
+
+        int progress = (tNo * 100) / tests;
+
+        if (progress != perc)
+        {
+            perc = progress;
+            cout << perc << " %\r" << flush;
+        }
+    }
+
+    remove(path.c_str());
+
+    if (allPassed)
+    {
+        cout << "All tests passed." << endl;
+    }
+
+    return allPassed;
+}
+
+// Tests the intersection of reduced sets with each supported kernel and
+// each pair of formats against std::set_intersection. Uses both & and &=.
+bool Testing::reducedSetKernels(unsigned int seed, size_t tests, size_t maxSize)
+{
+    cout << "\nTesting Kernels of Reduced Sets." << endl
+         << tests << " test cases with max. size " << maxSize << "." << endl;
+
+
+    typedef ReducedSet::Kernel Kernel;
+    typedef ReducedSet::Format Format;
+
+    const vector<pair<Kernel, string>> kernels =
+    {
+        { Kernel::Scalar, "Scalar" },
+        { Kernel::AVX2, "AVX2" },
+        { Kernel::AVX512, "AVX512" }
+    };
+
+    const vector<Format> formats = { Format::Reduced, Format::Dense, Format::Auto };
+
+    for (const auto& kernel : kernels)
+    {
+        if (!ReducedSet::isSupported(kernel.first))
+        {
+            cout << kernel.second << " is not supported and not tested." << endl;
+        }
+    }
+
+
+    srand(seed);
+    bool allPassed = true;
+
+
+    for (size_t tNo = 1, perc = -1; tNo <= tests && allPassed; tNo++)
+    {
+        // --- Create random sets. ---
+
+        // Sets are over up to 64 * maxSize elements, i.e., maxSize words.
+        int universe = rand() % (64 * maxSize) + 1;
+
+        vector<int> lList = randomSubset(universe);
+        vector<int> rList = randomSubset(universe);
+
+        vector<int> expected;
+        set_intersection(lList.begin(), lList.end(), rList.begin(), rList.end(), back_inserter(expected));
+
+
+        // --- Intersect with each kernel and pair of formats. ---
+
+        for (const auto& kernel : kernels)
+        {
+            if (!ReducedSet::useKernel(kernel.first)) continue;
+
+            for (const Format& lFormat : formats)
+            {
+                for (const Format& rFormat : formats)
+                {
+                    ReducedSet lSet(lList, lFormat);
+                    ReducedSet rSet(rList, rFormat);
+
+                    bool andOk = elements(lSet & rSet) == expected;
+
+                    lSet &= rSet;
+                    bool andAssignOk = elements(lSet) == expected;
+
+                    if (allPassed && (!andOk || !andAssignOk))
+                    {
+                        cout << "Test " << tNo << " failed: " << kernel.second << " kernel with formats "
+                             << (int)lFormat << " and " << (int)rFormat << " (" << (andOk ? "&=" : "&") << ")." << endl;
+                        allPassed = false;
+                    }
+                }
+            }
+        }
+
+
+        // --- Print progress. ---
+
+        int progress = (tNo * 100) / tests;
+
+        if (progress != perc)
+        {
+            perc = progress;
+            cout << perc << " %\r" << flush;
+        }
+    }
+
+    ReducedSet::useKernel(ReducedSet::defaultKernel());
+
+    if (allPassed)
+    {
+        cout << "All tests passed." << endl;
+    }
+
+    return allPassed;
+}
+
+// Tests the stack of reduced sets against intersections of individual sets.
+// Also verifies that a stack does not allocate memory when the same
+// operations are repeated (i.e., once its buffer is large enough).
+bool Testing::reducedSetStack(unsigned int seed, size_t tests, size_t maxSize)
+{
+    cout << "\nTesting Stack of Reduced Sets." << endl
+         << tests << " test cases with max. size " << maxSize << "." << endl;
+
+    if (!countsAllocations())
+    {
+        cout << "Test skipped: allocations are not counted (build with COUNT_ALLOCATIONS)." << endl;
+        return false;
+    }
+
+
+    srand(seed);
+    bool allPassed = true;
+
+
+    for (size_t tNo = 1, perc = -1; tNo <= tests && allPassed; tNo++)
+    {
+        // --- Create random sets. ---
+
+        size_t universe = rand() % maxSize + 5;
+        size_t setCount = rand() % 20 + 2;
+
+        vector<ReducedSet> sets;
+
+        for (size_t i = 0; i < setCount; i++)
+        {
+            // Dense sets, so that intersections of several sets are not empty.
+            int density = rand() % 50 + 50;
+            vector<int> list;
+
+            for (size_t x = 0; x < universe; x++)
+            {
+                if (rand() % 100 < density) list.push_back(x);
+            }
+
+            sets.push_back(ReducedSet(list));
+        }
+
+
+        // --- Run the same operations twice. ---
+
+        // Simulates Pritchard's algorithm: rewind to a random depth, then
+        // intersect with random sets. The reference is computed with the
+        // operators of ReducedSet.
+
+        ReducedSet::Stack stack;
+        unsigned int opSeed = rand();
+
+        for (int pass = 0; pass < 2 && allPassed; pass++)
+        {
+            srand(opSeed);
+
+            vector<ReducedSet> reference;
+            size_t allocations = 0;
+
+            for (int round = 0; round < 50; round++)
+            {
+                size_t depth = rand() % (reference.size() + 1);
+                size_t steps = rand() % 10;
+                bool inPlace = rand() % 2 == 0;
+
+                size_t before = allocationCount();
+                stack.resize(depth);
+                allocations += allocationCount() - before;
+                reference.resize(depth);
+
+                if (depth == 0)
+                {
+                    const ReducedSet& set = sets[rand() % setCount];
+
+                    before = allocationCount();
+                    stack.push(set);
+                    allocations += allocationCount() - before;
+                    reference.push_back(set);
+                }
+
+                for (size_t i = 0; i < steps; i++)
+                {
+                    const ReducedSet& set = sets[rand() % setCount];
+
+                    before = allocationCount();
+                    if (inPlace) stack.intersectTop(set);
+                    else stack.pushIntersection(set);
+                    allocations += allocationCount() - before;
+
+                    if (inPlace) reference.back() &= set;
+                    else reference.push_back(reference.back() & set);
+                }
+
+
+                // Compare top sets.
+                before = allocationCount();
+                auto sIt = stack.begin();
+                auto sEnd = stack.end();
+                allocations += allocationCount() - before;
+
+                auto rIt = reference.back().begin();
+                auto rEnd = reference.back().end();
+
+                for (; sIt != sEnd && rIt != rEnd; ++sIt, ++rIt)
+                {
+                    if (*sIt != *rIt) break;
+                }
+
+                if (stack.size() != reference.size() || sIt != sEnd || rIt != rEnd)
+                {
+                    cout << "Test " << tNo << " failed: wrong intersection." << endl;
+                    allPassed = false;
+                    break;
+                }
+            }
+
+            // Second pass needs the same amount of memory. No new allocations.
+            if (allPassed && pass == 1 && allocations > 0)
+            {
+                cout << "Test " << tNo << " failed: "
+                     << allocations << " allocations in second pass." << endl;
+                allPassed = false;
+            }
+        }
+
+
+        // --- Print progress. ---
+
+        int progress = (tNo * 100) / tests;
+
+        if (progress != perc)
+        {
+            perc = progress;
+            cout << perc << " %\r" << flush;
+        }
+    }
+
+    if (allPassed)
+    {
+        cout << "All tests passed." << endl;
+    }
+
+    return allPassed;
+}
+
+// Tests batched partition refinement against refining with one list at a
+// time. Both have to result in the same groups in the same order.
+bool Testing::batchRefinement(unsigned int seed, size_t tests, size_t maxSize)
+{
+    cout << "\nTesting Batched Partition Refinement." << endl
+         << tests << " test cases with max. size " << maxSize << "." << endl;
+
+
+    srand(seed);
+    bool allPassed = true;
+
+
+    for (size_t tNo = 1, perc = -1; tNo <= tests && allPassed; tNo++)
+    {
+        // --- Create random lists. ---
+
+        size_t k = rand() % maxSize + 5;
+        size_t listCount = rand() % (2 * k) + 1;
+
+        vector<vector<int>> lists(listCount);
+
+        for (vector<int>& list : lists)
+        {
+            size_t density = rand() % 30 + 1;
+
+            for (int id = 0; id < k; id++)
+            {
+                if (rand() % 100 < density) list.push_back(id);
+            }
+
+            random_shuffle(list.begin(), list.end());
+        }
+
+
+        // --- Refine. ---
+
+        try
+        {
+            PartRefinement single(k);
+            PartRefinement batch(k);
+
+            size_t singleGroups = 0;
+            size_t batchGroups = 0;
+
+            for (const vector<int>& list : lists)
+            {
+                single.refine(list, [&singleGroups](size_t) { singleGroups++; });
+            }
+
+            // Random batch sizes, including empty batches.
+            vector<IdSpan> batchLists;
+
+            for (size_t i = 0; i < listCount;)
+            {
+                size_t batchSize = rand() % 8;
+                batchLists.clear();
+
+                for (; batchLists.size() < batchSize && i < listCount; i++)
+                {
+                    batchLists.push_back(lists[i]);
+                }
+
+                batch.refineBatch(batchLists, [&batchGroups](size_t) { batchGroups++; });
+            }
+
+
+            // --- Compare groups. ---
+
+            // Order within a group may differ. Hence, compare the group
+            // boundaries along the order.
+
+            const vector<int>& sOrder = single.getOrder();
+            const vector<int>& bOrder = batch.getOrder();
+
+            bool same = single.size() == batch.size() && singleGroups == batchGroups;
+
+            for (size_t i = 0; i < k && same; i++)
+            {
+                same =
+                    single.groupOf(sOrder[i]) == single.groupOf(bOrder[i]) &&
+                    batch.groupOf(sOrder[i]) == batch.groupOf(bOrder[i]);
+
+                if (i > 0)
+                {
+                    bool sSplit = single.groupOf(sOrder[i - 1]) != single.groupOf(sOrder[i]);
+                    bool bSplit = batch.groupOf(bOrder[i - 1]) != batch.groupOf(bOrder[i]);
+                    same &= sSplit == bSplit;
+                }
+            }
+
+            if (!same)
+            {
+                cout << "Test " << tNo << " failed: groups differ." << endl;
+                allPassed = false;
+            }
+        }
+        catch (const exception& e)
+        {
+            cout << "Test " << tNo << " failed with exception." << endl;
+            cerr << e.what() << endl;
+            allPassed = false;
+        }
+
+
+        // --- Print progress. ---
+
+        int progress = (tNo * 100) / tests;
+
+        if (progress != perc)
+        {
+            perc = progress;
+            cout << perc << " %\r" << flush;
+        }
+    }
+
+    if (allPassed)
+    {
+        cout << "All tests passed." << endl;
+    }
+
+    return allPassed;
+}
+
+// Tests PackedMaxCardinalitySet against MaxCardinalitySet. Both have to
+// remove sets in the same order. Also checks the sizes of removed sets.
+bool Testing::maxCardinalitySets(unsigned int seed, size_t tests, size_t maxSize)
+{
+    cout << "\nTesting Packed Max. Cardinality Sets." << endl
+         << tests << " test cases with max. size " << maxSize << "." << endl;
+
+
+    srand(seed);
+    bool allPassed = true;
+
+
+    for (size_t tNo = 1, perc = -1; tNo <= tests && allPassed; tNo++)
+    {
+        // --- Create sets. ---
+
+        size_t k = rand() % maxSize + 1;
+        size_t maxSetSize = rand() % maxSize + 1;
+
+        MaxCardinalitySet expSets(k);
+        PackedMaxCardinalitySet sets(k, maxSetSize);
+
+        vector<int> sizes(k, 0);
+        vector<bool> removed(k, false);
+
+
+        // --- Increase and remove alternately. ---
+
+        try
+        {
+            for (size_t step = 0; step < k && allPassed; step++)
+            {
+                // Increase the sizes of random sets, individually or in bulk.
+                // Bulk increases may contain removed sets, which are ignored.
+                size_t increases = rand() % 8;
+
+                for (size_t i = 0; i < increases; i++)
+                {
+                    vector<int> setIds;
+                    size_t count = rand() % 2 == 0 ? 1 : rand() % 5;
+
+                    for (size_t j = 0; j < count; j++)
+                    {
+                        int setId = rand() % k;
+                        if (sizes[setId] < maxSetSize) setIds.push_back(setId);
+                    }
+
+                    // A set may only appear once in a bulk increase.
+                    sort(setIds.begin(), setIds.end());
+                    setIds.erase(unique(setIds.begin(), setIds.end()), setIds.end());
+
+                    for (int setId : setIds)
+                    {
+                        if (removed[setId]) continue;
+
+                        expSets.increaseSize(setId);
+                        sizes[setId]++;
+                    }
+
+                    if (count == 1)
+                    {
+                        for (int setId : setIds)
+                        {
+                            if (!removed[setId]) sets.increaseSize(setId);
+                        }
+                    }
+                    else
+                    {
+                        sets.increaseSizes(setIds);
+                    }
+                }
+
+                // Remove a largest set.
+                int expId = expSets.removeMax();
+                int setId = sets.removeMax();
+
+                if (setId != expId)
+                {
+                    cout << "Test " << tNo << " failed: removed set " << setId << " instead of " << expId << "." << endl;
+                    allPassed = false;
+                }
+                else if (sets.sizeOf(setId) != sizes[setId])
+                {
+                    cout << "Test " << tNo << " failed: removed set has size " << sets.sizeOf(setId)
+                         << " instead of " << sizes[setId] << "." << endl;
+                    allPassed = false;
+                }
+
+                removed[setId] = true;
+            }
+
+            if (allPassed && (!sets.isEmpty() || !expSets.isEmpty()))
+            {
+                cout << "Test " << tNo << " failed: sets are not empty." << endl;
+                allPassed = false;
+            }
+
+            // Removed sets keep their size.
+            for (int setId = 0; setId < k && allPassed; setId++)
+            {
+                if (sets.sizeOf(setId) != sizes[setId])
+                {
+                    cout << "Test " << tNo << " failed: set " << setId << " has size " << sets.sizeOf(setId)
+                         << " instead of " << sizes[setId] << "." << endl;
+                    allPassed = false;
+                }
+            }
+        }
+        catch (const exception& e)
+        {
+            cout << "Test " << tNo << " failed with exception." << endl;
+            cerr << e.what() << endl;
+            allPassed = false;
+        }
+
+
+        // --- Print progress. ---
+
+        int progress = (tNo * 100) / tests;
+
+        if (progress != perc)
+        {
+            perc = progress;
+            cout << perc << " %\r" << flush;
+        }
+    }
+
+    if (allPassed)
+    {
+        cout << "All tests passed." << endl;
+    }
+
+    return allPassed;
+}
+
+// Tests a given function that computes the subset graph of a given hypergraph.
+// Returns the time needed in milliseconds.
+uint64_t Testing::unionJoinGraph(ujgAlgo algo, string name, unsigned int seed, size_t tests, size_t maxSize)
+{
+    cout << "\nTesting Union Join Graph Implementation: " << name << endl
+         << tests << " test cases with max. size " << maxSize << "." << endl;
+
+
+    srand(seed);
+    auto start = high_resolution_clock::now();
+
+
+    for (size_t tNo = 1, perc = -1; tNo < tests; tNo++)
+    {
+        // --- Determine size and create hypergraph. ---
+
+        size_t sz = rand() % maxSize + 5;
+        size_t N = sz + rand() % (sz * LogC(sz)) + 1;
+
+        Hypergraph aaHg = AlphaAcyclic::genrate(sz, N);
+
+
+        // --- Run tests. ---
+
+        try
+        {
+            Graph ujg = algo(aaHg);
+        }
+        catch (const exception& e)
+        {
+            cout << "Test " << tNo << " failed with exception." << endl;
+            cerr << e.what() << endl;
+            break;
+        }
+
+
+        // --- Print progress. ---
+
+        int progress = (tNo * 100) / tests;
+
+        if (progress != perc)
+        {
+            perc = progress;
+            cout << perc << " %\r" << flush;
+        }
+    }
+
+    auto end = high_resolution_clock::now();
+    return duration_cast<milliseconds>(end - start).count();
+}
+
+// Tests if two given algorithms return the same result.
+bool Testing::unionJoinGraph(ujgAlgo algo1, ujgAlgo algo2, unsigned int seed, size_t tests, size_t maxSize)
+{
+    cout << "\nTesting Result of Union Join Graph Implementations." << endl
+         << tests << " test cases with max. size " << maxSize << "." << endl;
+
+
+    srand(seed);
+    bool allPassed = true;
+
+
+    for (size_t tNo = 1, perc = -1; tNo < tests; tNo++)
+    {
+        // --- Determine size and create hypergraph. ---
+
+        size_t sz = rand() % maxSize + 5;
+        size_t N = sz + rand() % (sz * LogC(sz)) + 1;
+
+        Hypergraph aaHg = AlphaAcyclic::genrate(sz, N);
+
+
+        // --- Run tests. ---
+
+        bool equal = false;
+
+        try
+        {
+            equal = UnionJoinTest::compareAlgorithms(aaHg, algo1, algo2);
+        }
+        catch (const exception& e)
+        {
+            cout << "Test " << tNo << " failed with exception." << endl;
+            cerr << e.what() << endl;
+            allPassed = false;
+            break;
+        }
+
+
+        if (!equal)
+        {
+            cout << "Test " << tNo << " failed." << endl;
+            allPassed = false;
+            break;
+        }
+
+
+        // --- Print progress. ---
+
+        int progress = (tNo * 100) / tests;
+
+        if (progress != perc)
+        {
+            perc = progress;
+            cout << perc << " %\r" << flush;
+        }
+    }
+
+    if (allPassed)
+    {
+        cout << "All tests passed." << endl;
+    }
+
+    return allPassed;
+}
+
+// Tests the compact subset graph of interval hypergraphs against the naive
+// algorithm. Checks the expanded edges as well as isSubset().
+bool Testing::intervalSubsetGraph(unsigned int seed, size_t tests, size_t maxSize)
+{
+    cout << "\nTesting Compact Subset Graphs of Interval Hypergraphs." << endl
+         << tests << " test cases with max. size " << maxSize << "." << endl;
+
+
+    srand(seed);
+    bool allPassed = true;
+
+
+    for (size_t tNo = 1, perc = -1; tNo < tests; tNo++)
+    {
+        // --- Determine size and create hypergraph. ---
+
+        size_t sz = rand() % maxSize + 5;
+        size_t N = sz + rand() % (sz * LogC(sz)) + 1;
+
+        Hypergraph hg = Interval::genrate(sz, N);
+
+
+        // --- Run tests. ---
+
+        bool equal = true;
+
+        try
+        {
+            IntervalSubsetGraph ssg = Interval::compactSubsetGraph(hg);
+
+            vector<intPair> expected = SubsetGraph::naive(hg);
+            equal &= ssg.toEdges() == expected;
+            equal &= ssg.edgeCount() == expected.size();
+
+            // An edge (x, y) states that y is a subset of x.
+            size_t count = 0;
+            for (int xId = 0; xId < hg.getESize(); xId++)
+            {
+                for (int yId = 0; yId < hg.getESize(); yId++)
+                {
+                    if (ssg.isSubset(yId, xId)) count++;
+                }
+            }
+
+            equal &= count == expected.size();
+        }
+        catch (const exception& e)
+        {
+            cout << "Test " << tNo << " failed with exception." << endl;
+            cerr << e.what() << endl;
+            allPassed = false;
+            break;
+        }
+
+
+        if (!equal)
+        {
+            cout << "Test " << tNo << " failed." << endl;
+            allPassed = false;
+            break;
+        }
+
+
+        // --- Print progress. ---
+
+        int progress = (tNo * 100) / tests;
+
+        if (progress != perc)
+        {
+            perc = progress;
+            cout << perc << " %\r" << flush;
+        }
+    }
+
+    if (allPassed)
+    {
+        cout << "All tests passed." << endl;
+    }
+
+    return allPassed;
+}
+
+// Tests the CSR union join graphs (full and half storage) of alpha-acyclic,
+// interval, and gamma-acyclic hypergraphs against their Graph versions.
+bool Testing::unionJoinCsr(unsigned int seed, size_t tests, size_t maxSize)
+{
+    cout << "\nTesting CSR Union Join Graphs." << endl
+         << tests << " test cases with max. size " << maxSize << "." << endl;
+
+
+    srand(seed);
+    bool allPassed = true;
+
+
+    for (size_t tNo = 1, perc = -1; tNo < tests; tNo++)
+    {
+        // --- Determine size and create hypergraphs. ---
+
+        size_t sz = rand() % maxSize + 5;
+        size_t N = sz + rand() % (sz * LogC(sz)) + 1;
+
+        Hypergraph aaHg = AlphaAcyclic::genrate(sz, N);
+        Hypergraph inHg = Interval::genrate(sz, N);
+        Hypergraph gaHg = GammaAcyclic::genrate(sz, 2 * sz);
+
+
+        // --- Run tests. ---
+
+        bool equal = true;
+
+        try
+        {
+            for (bool half : { false, true })
+            {
+                equal &= UnionJoinTest::compareCsr(AlphaAcyclic::unionJoinGraph(aaHg), AlphaAcyclic::unionJoinCsr(aaHg, half));
+                equal &= UnionJoinTest::compareCsr(Interval::unionJoinGraph(inHg), Interval::unionJoinCsr(inHg, half));
+                equal &= UnionJoinTest::compareCsr(GammaAcyclic::unionJoinGraph(gaHg), GammaAcyclic::unionJoinCsr(gaHg, half));
+            }
+        }
+        catch (const exception& e)
+        {
+            cout << "Test " << tNo << " failed with exception." << endl;
+            cerr << e.what() << endl;
+            allPassed = false;
+            break;
+        }
+
+
+        if (!equal)
+        {
+            cout << "Test " << tNo << " failed." << endl;
+            allPassed = false;
+            break;
+        }
+
+
+        // --- Print progress. ---
+
+        int progress = (tNo * 100) / tests;
+
+        if (progress != perc)
+        {
+            perc = progress;
+            cout << perc << " %\r" << flush;
+        }
+    }
+
+    if (allPassed)
+    {
+        cout << "All tests passed." << endl;
+    }
+
+    return allPassed;
+}
+
+// Tests IncrementalUnionJoin with random insertions and removals, some of
+// which make the hypergraph cyclic and acyclic again. After each update,
+// compares union join graph and acyclicity with AlphaAcyclic, and checks
+// that join tree and separators are valid.
+bool Testing::incrementalUnionJoin(unsigned int seed, size_t tests, size_t maxSize)
+{
+    cout << "\nTesting Incremental Union Join Graph." << endl
+         << tests << " test cases with max. size " << maxSize << "." << endl;
+
+
+    srand(seed);
+    bool allPassed = true;
+
+
+    for (size_t tNo = 1, perc = -1; tNo <= tests && allPassed; tNo++)
+    {
+        // --- Determine size and create hypergraph. ---
+
+        size_t sz = rand() % maxSize + 5;
+        size_t N = sz + rand() % (sz * LogC(sz)) + 1;
+
+        Hypergraph hg = AlphaAcyclic::genrate(sz, N);
+        int n = hg.getVSize();
+
+
+        // --- Run updates. ---
+
+        try
+        {
+            IncrementalUnionJoin iuj(hg);
+            string error = checkIncremental(iuj);
+
+            // Removed hyperedges (to insert them again) and random hyperedges
+            // (to remove them again, which likely makes the hypergraph acyclic).
+            vector<vector<int>> removed;
+            vector<int> randomIds;
+
+            for (size_t step = 0; step < 30 && error.empty(); step++)
+            {
+                int op = rand() % 4;
+
+                if (op == 0)
+                {
+                    // Remove random hyperedge.
+                    int eId = rand() % iuj.size();
+                    if (!iuj.contains(eId)) continue;
+
+                    removed.push_back(iuj[eId]);
+                    iuj.remove(eId);
+                }
+                else if (op == 1 && !removed.empty())
+                {
+                    // Insert removed hyperedge again.
+                    size_t idx = rand() % removed.size();
+                    iuj.insert(removed[idx]);
+
+                    removed[idx] = removed.back();
+                    removed.pop_back();
+                }
+                else if (op == 2)
+                {
+                    // Insert random hyperedge. Often creates a cycle. Vertices
+                    // beyond n create new components or connect existing ones.
+                    vector<int> vList;
+                    size_t size = rand() % 4 + 2;
+                    int range = rand() % 2 == 0 ? n : n + 2 * sz;
+
+                    for (size_t i = 0; i < size; i++)
+                    {
+                        vList.push_back(rand() % range);
+                    }
+
+                    randomIds.push_back(iuj.insert(vList));
+                }
+                else if (!randomIds.empty())
+                {
+                    // Remove latest random hyperedge.
+                    int eId = randomIds.back();
+                    randomIds.pop_back();
+
+                    if (iuj.contains(eId)) iuj.remove(eId);
+                }
+                else
+                {
+                    continue;
+                }
+
+                error = checkIncremental(iuj);
+            }
+
+            if (!error.empty())
+            {
+                cout << "Test " << tNo << " failed: " << error << endl;
+                allPassed = false;
+            }
+        }
+        catch (const exception& e)
+        {
+            cout << "Test " << tNo << " failed with exception." << endl;
+            cerr << e.what() << endl;
             allPassed = false;
-            break;
         }
 
 
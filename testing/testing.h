@@ -13,7 +13,56 @@ namespace Testing
     // --- Subset Graph ---
 
     // Tests a given function that computes the subset graph of a given hypergraph.
-    void testGeneralSSG(SubsetGraph::ssgAlgo ssg, int seed, int tests, int maxSize);
+    bool testGeneralSSG(SubsetGraph::ssgAlgo ssg, int seed, int tests, int maxSize);
+
+    // Tests the parallel subset graph algorithm with multiple threads and more
+    // hyperedges than one block contains.
+    bool parallelSSG(unsigned int seed, size_t tests, size_t maxSize);
+
+    // Tests that the loop of pritchardRefinement() only allocates memory when
+    // its history grows, i.e., a logarithmic number of times.
+    bool pritchardAllocations(unsigned int seed, size_t tests, size_t maxSize);
+
+    // Tests the compact subset graph of interval hypergraphs against the naive
+    // algorithm. Checks the expanded edges as well as isSubset().
+    bool intervalSubsetGraph(unsigned int seed, size_t tests, size_t maxSize);
+
+
+    // --- Linegraph ---
+
+    // Tests if the linegraph engines (Scan, Degree, and Auto) compute the same
+    // linegraph. Uses random and power-law hypergraphs, and hypergraphs with
+    // no heavy vertex and with more than 64 heavy vertices.
+    bool linegraphEngines(unsigned int seed, size_t tests, size_t maxSize);
+
+
+    // --- Data Structures ---
+
+    // Tests saving and loading hypergraphs in binary files, with and without
+    // sets of vertices. Also verifies that corrupted files are rejected.
+    bool hypergraphFiles(unsigned int seed, size_t tests, size_t maxSize);
+
+    // Tests reading hypergraphs from text files in both formats. Files contain
+    // comments, empty lines, repeated pairs, and sometimes no final line
+    // break. Also reads one file that is large enough to be split into chunks.
+    bool hypergraphText(unsigned int seed, size_t tests, size_t maxSize);
+
+    // Tests the intersection of reduced sets with each supported kernel and
+    // each pair of formats against std::set_intersection. Uses both & and &=.
+    bool reducedSetKernels(unsigned int seed, size_t tests, size_t maxSize);
+
+    // Tests the stack of reduced sets against intersections of individual sets.
+    // Also verifies that a stack does not allocate memory when the same
+    // operations are repeated (i.e., once its buffer is large enough).
+    bool reducedSetStack(unsigned int seed, size_t tests, size_t maxSize);
+
+    // Tests batched partition refinement against refining with one list at a
+    // time. Both have to result in the same groups in the same order.
+    bool batchRefinement(unsigned int seed, size_t tests, size_t maxSize);
+
+    // Tests PackedMaxCardinalitySet against MaxCardinalitySet. Both have to
+    // remove sets in the same order. Also checks the sizes of removed sets.
+    bool maxCardinalitySets(unsigned int seed, size_t tests, size_t maxSize);
 
 
     // --- Union Join Graph ---
@@ -24,6 +73,16 @@ namespace Testing
 
     // Tests if two given algorithms return the same result.
     bool unionJoinGraph(ujgAlgo algo1, ujgAlgo algo2, unsigned int seed, size_t tests, size_t maxSize);
+
+    // Tests the CSR union join graphs (full and half storage) of alpha-acyclic,
+    // interval, and gamma-acyclic hypergraphs against their Graph versions.
+    bool unionJoinCsr(unsigned int seed, size_t tests, size_t maxSize);
+
+    // Tests IncrementalUnionJoin with random insertions and removals, some of
+    // which make the hypergraph cyclic and acyclic again. After each update,
+    // compares union join graph and acyclicity with AlphaAcyclic, and checks
+    // that join tree and separators are valid.
+    bool incrementalUnionJoin(unsigned int seed, size_t tests, size_t maxSize);
 }
 
 #endif
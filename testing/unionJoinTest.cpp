@@ -18,6 +18,13 @@ Graph Testing::UnionJoinTest::ujgLeitertPritchardSpeedUp(const Hypergraph& hg)
     return AlphaAcyclic::unionJoinGraph(hg);
 }
 
+// Computes the union join graph of a given acyclic hypergraph using my
+// algorithm which suppresses duplicate edges while generating them.
+Graph Testing::UnionJoinTest::ujgLeitertLowMemory(const Hypergraph& hg)
+{
+    return AlphaAcyclic::unionJoinGraph(hg, true);
+}
+
 // Computes the union join graph of a given acyclic hypergraph using the
 // linegraph and a modification of Kruskal's algorithm.
 Graph Testing::UnionJoinTest::ujgLineKruskal(const Hypergraph& hg)
@@ -33,6 +40,32 @@ Graph Testing::UnionJoinTest::ujgLineKruskal(const Hypergraph& hg)
     return Graph(edges, weights);
 }
 
+// Computes the union join graph of a given acyclic hypergraph using the
+// linegraph and checking each of its edges individually.
+Graph Testing::UnionJoinTest::ujgLineCheckAll(const Hypergraph& hg)
+{
+    Graph lg = hg.getLinegraph();
+
+    // Edges have from-ID < to-ID.
+    vector<intPair> edges = MstEdges::checkAllEdges(lg);
+    for (intPair& edge : edges) swap(edge.first, edge.second);
+    Sorting::radixSort(edges);
+
+    return Graph(move(edges));
+}
+
+// Computes the union join graph of a given acyclic hypergraph using the
+// linegraph and the smallest weights on the paths of one MaxST.
+Graph Testing::UnionJoinTest::ujgLineBottleneck(const Hypergraph& hg)
+{
+    Graph lg = hg.getLinegraph();
+
+    // Edges are already sorted.
+    vector<intPair> edges = MstEdges::bottleneckTree(lg);
+
+    return Graph(move(edges));
+}
+
 // Runs two union join graph algorithms and verifies that their output is the same.
 bool Testing::UnionJoinTest::compareAlgorithms(const Hypergraph& hg, ujgAlgo algo1, ujgAlgo algo2)
 {
@@ -49,7 +82,7 @@ bool Testing::UnionJoinTest::compareAlgorithms(const Hypergraph& hg, ujgAlgo alg
         const vector<int>& neiV1 = ujg1[vId];
         const vector<int>& neiV2 = ujg2[vId];
 
-        if (ujg1.size() != ujg2.size()) return false;
+        if (neiV1.size() != neiV2.size()) return false;
 
         for (int i = 0; i < neiV1.size(); i++)
         {
@@ -59,3 +92,32 @@ bool Testing::UnionJoinTest::compareAlgorithms(const Hypergraph& hg, ujgAlgo alg
 
     return true;
 }
+
+// Verifies that a CSR graph has the same edges as a given graph.
+// With half storage, only neighbours with smaller ID are expected.
+bool Testing::UnionJoinTest::compareCsr(const Graph& g, const CsrGraph& csr)
+{
+    // Graph only knows vertices up to the largest ID with an edge.
+    if (g.size() > csr.size()) return false;
+
+    size_t edges = 0;
+
+    for (int vId = 0; vId < csr.size(); vId++)
+    {
+        vector<int> expected;
+
+        if (vId < g.size())
+        {
+            for (const int& uId : g[vId])
+            {
+                if (!csr.isHalf() || uId < vId) expected.push_back(uId);
+            }
+        }
+
+        if (csr[vId].toVector() != expected) return false;
+
+        edges += expected.size();
+    }
+
+    return csr.edgeCount() == (csr.isHalf() ? edges : edges / 2);
+}
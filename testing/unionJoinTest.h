@@ -4,6 +4,7 @@
 #define __Testing_UnionJoinTest_H__
 
 
+#include "../dataStructures/csrGraph.h"
 #include "../dataStructures/graph.h"
 #include "../dataStructures/hypergraph.h"
 
@@ -24,13 +25,29 @@ namespace Testing
         // algorithm with Pritchard's algorithm for subset graphs.
         Graph ujgLeitertPritchardSpeedUp(const Hypergraph&);
 
+        // Computes the union join graph of a given acyclic hypergraph using my
+        // algorithm which suppresses duplicate edges while generating them.
+        Graph ujgLeitertLowMemory(const Hypergraph&);
+
         // Computes the union join graph of a given acyclic hypergraph using the
         // linegraph and a modification of Kruskal's algorithm.
         Graph ujgLineKruskal(const Hypergraph&);
 
+        // Computes the union join graph of a given acyclic hypergraph using the
+        // linegraph and checking each of its edges individually.
+        Graph ujgLineCheckAll(const Hypergraph&);
+
+        // Computes the union join graph of a given acyclic hypergraph using the
+        // linegraph and the smallest weights on the paths of one MaxST.
+        Graph ujgLineBottleneck(const Hypergraph&);
+
 
         // Runs two union join graph algorithms and verifies that their output is the same.
         bool compareAlgorithms(const Hypergraph& hg, ujgAlgo algo1, ujgAlgo algo2);
+
+        // Verifies that a CSR graph has the same edges as a given graph.
+        // With half storage, only neighbours with smaller ID are expected.
+        bool compareCsr(const Graph& g, const CsrGraph& csr);
     };
 }
 